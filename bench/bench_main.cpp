@@ -0,0 +1,666 @@
+/**
+ * @file bench_main.cpp
+ * @brief Host microbenchmarks for the edge_pm data path.
+ *
+ * Measures the circular buffer, the wrapper lookups, the detection kernel,
+ * the FFT, the instrumentation hooks, the compressed and flash histories, the rollups, the signal simulator and the whole acquisition-to-detection path at fleet sizes from
+ * 3 to 10,000 sensors, and writes the results as JSON so runs can be
+ * compared between releases.
+ *
+ * The pipeline benchmark runs the data path of Threads 2 and 3 on one
+ * thread (reserve/commit into the ring, zero-copy drain, range check,
+ * statistics, sliding windows); kernel hand-offs are not included.
+ * Correctness checks live in test_main.cpp; this suite only measures.
+ *
+ * Usage: pm_bench [--quick] [-o results.json]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Core modules are plain C without C++ guards
+extern "C" {
+#include "shared_resources.h"
+#include "circular_buffer.h"
+#include "detection.h"
+#include "statistics.h"
+#include "window.h"
+#include "instrument.h"
+#include "store.h"
+#include "history.h"
+#include "rollup.h"
+#include "simulator.h"
+#include <zephyr/storage/flash_map.h>
+}
+#include "spectrum.h"
+#include "wrapper.h"
+#include "sensor_bank.h"
+
+/** @brief Kernel objects referenced by shared_resources.h (inert on the host) */
+struct k_msgq log_queue;
+struct k_msgq anomaly_queue;
+struct k_sem sensor_update_sem;
+struct k_sem buffer_data_sem;
+
+/** @brief Fleet sizes of the pipeline benchmark */
+static const uint32_t fleetSizes[] = { 3U, 10U, 100U, 1000U, 10000U };
+
+/** @brief Keeps results observable so the optimizer cannot drop the work */
+static volatile uint32_t sink;
+
+/** @brief One measured value of the report */
+struct Result {
+    std::string name;
+    std::string unit;
+    double      value;
+    uint32_t    sensors;            // Fleet size, 0 if not applicable
+};
+
+static std::vector<Result> results;
+
+/** @brief xorshift32 - cheap, deterministic test data */
+static uint32_t rngState = 0x9E3779B9U;
+
+static float nextUniform()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Time a callable that performs ops operations.
+ *
+ * @return Nanoseconds per operation
+*/
+template <typename Fn>
+static double timeNsPerOp(uint64_t ops, Fn&& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    return ns / static_cast<double>(ops);
+}
+
+static void record(const char* name, const char* unit, double value, uint32_t sensors = 0U)
+{
+    results.push_back({ name, unit, value, sensors });
+}
+
+/**
+ * @brief cb_write / cb_read cost, the zero-copy reserve/commit and peek/release paths,
+ *        and the cost per reading of delivering it to several readers.
+*/
+static void benchCircularBuffer(uint64_t ops)
+{
+    static CircularBuffer cb;
+    struct sensor_reading in = { 0U, PM_VALUE(1.0f), 0U, 0U };
+    struct sensor_reading out;
+    const uint32_t burst = BUFFER_SIZE / 2U;
+
+    circular_buffer_init(&cb, CB_OVERWRITE_OLDEST);
+    cb_reader_t* reader = cb_reader_register(&cb, "bench", nullptr);
+
+    // Alternate bursts so writes never overwrite and reads never run dry
+    double writeNs = 0.0;
+    double readNs  = 0.0;
+    for (uint64_t done = 0U; done < ops; done += burst) {
+        writeNs += timeNsPerOp(1U, [&] {
+            for (uint32_t i = 0U; i < burst; i++) {
+                in.timestamp_ms = i;
+                (void)cb_write(&cb, &in);
+            }
+        });
+        readNs += timeNsPerOp(1U, [&] {
+            for (uint32_t i = 0U; i < burst; i++) {
+                sink += cb_read(&cb, reader, &out) ? out.timestamp_ms : 0U;
+            }
+        });
+    }
+    record("cb_write", "ns/op", writeNs / static_cast<double>(ops));
+    record("cb_read", "ns/op", readNs / static_cast<double>(ops));
+
+    double zeroCopyNs = timeNsPerOp(ops, [&] {
+        for (uint64_t done = 0U; done < ops; done += burst) {
+            for (uint32_t i = 0U; i < burst; i++) {
+                struct sensor_reading* r = cb_write_reserve(&cb);
+                r->value = 1.0f;
+                cb_write_commit(&cb);
+            }
+            const struct sensor_reading* span;
+            uint32_t n;
+            while ((n = cb_read_peek(&cb, reader, &span)) > 0U) {
+                sink += static_cast<uint32_t>(span[0].value);
+                (void)cb_read_release(&cb, reader, n);
+            }
+        }
+    });
+    record("cb_reserve_commit_peek_release", "ns/op", zeroCopyNs);
+
+    // Same path with three readers sharing the one copy of each reading
+    circular_buffer_init(&cb, CB_OVERWRITE_OLDEST);
+    cb_reader_t* readers[3];
+    for (cb_reader_t*& r : readers) {
+        r = cb_reader_register(&cb, "bench", nullptr);
+    }
+    double broadcastNs = timeNsPerOp(ops, [&] {
+        for (uint64_t done = 0U; done < ops; done += burst) {
+            for (uint32_t i = 0U; i < burst; i++) {
+                struct sensor_reading* r = cb_write_reserve(&cb);
+                r->value = 1.0f;
+                cb_write_commit(&cb);
+            }
+            for (cb_reader_t* r : readers) {
+                const struct sensor_reading* span;
+                uint32_t n;
+                while ((n = cb_read_peek(&cb, r, &span)) > 0U) {
+                    sink += static_cast<uint32_t>(span[0].value);
+                    (void)cb_read_release(&cb, r, n);
+                }
+            }
+        }
+    });
+    record("cb_broadcast_3_readers", "ns/op", broadcastNs);
+}
+
+/**
+ * @brief Cost of the C wrapper API per sensor access over the ROM topology.
+*/
+static void benchWrapper(uint64_t ops)
+{
+    uint16_t machines = get_machine_count();
+    uint32_t sensors  = sensor_layout.count;
+    uint64_t rounds   = ops / sensors;
+
+    double indexNs = timeNsPerOp(rounds * sensors, [&] {
+        float acc = 0.0f;
+        for (uint64_t r = 0U; r < rounds; r++) {
+            for (uint16_t m = 0U; m < machines; m++) {
+                MachineHandle h = get_machine(m);
+                uint8_t n = get_sensor_count(h);
+                for (uint8_t i = 0U; i < n; i++) {
+                    acc += get_sensor_value_at(h, i);
+                }
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("wrapper_get_sensor_value_at", "ns/sensor", indexNs, sensors);
+
+    // Whole machines through the per-machine seqlock (uncontended - one attempt each)
+    double snapshotNs = timeNsPerOp(rounds * sensors, [&] {
+        pm_value_t value[UINT8_MAX];
+        uint32_t   ts[UINT8_MAX];
+        float      acc = 0.0f;
+        for (uint64_t r = 0U; r < rounds; r++) {
+            for (uint16_t m = 0U; m < machines; m++) {
+                MachineHandle h = get_machine(m);
+                uint8_t n = sensor_bank_snapshot(m, get_sensor_slot(h, 0U), get_sensor_count(h), value, ts);
+                for (uint8_t i = 0U; i < n; i++) {
+                    acc += pm_value_to_float(value[i]);
+                }
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("sensor_bank_snapshot", "ns/sensor", snapshotNs, sensors);
+
+    // Batch C API: everything about a machine / the fleet in one call
+    double machineSnapNs = timeNsPerOp(rounds * sensors, [&] {
+        static MachineSnapshot snap;
+        float acc = 0.0f;
+        for (uint64_t r = 0U; r < rounds; r++) {
+            for (uint16_t m = 0U; m < machines; m++) {
+                uint8_t n = get_machine_snapshot(get_machine(m), &snap);
+                for (uint8_t i = 0U; i < n; i++) {
+                    acc += snap.sensors[i].value + snap.sensors[i].max;
+                }
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("wrapper_get_machine_snapshot", "ns/sensor", machineSnapNs, sensors);
+
+    static SensorSnapshot fleet[MAX_FLEET_SENSORS];
+    double readAllNs = timeNsPerOp(rounds * sensors, [&] {
+        float acc = 0.0f;
+        for (uint64_t r = 0U; r < rounds; r++) {
+            uint32_t n = read_all_sensors(fleet, MAX_FLEET_SENSORS);
+            for (uint32_t i = 0U; i < n; i++) {
+                acc += fleet[i].value + fleet[i].max;
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("wrapper_read_all_sensors", "ns/sensor", readAllNs, sensors);
+
+    double stringNs = timeNsPerOp(rounds * sensors, [&] {
+        float acc = 0.0f;
+        for (uint64_t r = 0U; r < rounds; r++) {
+            for (uint16_t m = 0U; m < machines; m++) {
+                MachineHandle h = get_machine(m);
+                uint8_t n = get_sensor_count(h);
+                for (uint8_t i = 0U; i < n; i++) {
+                    acc += get_sensor_value(h, get_sensor_type(h, i));
+                }
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("wrapper_get_sensor_value_by_name", "ns/sensor", stringNs, sensors);
+
+    double findMachineNs = timeNsPerOp(ops, [&] {
+        uint32_t acc = 0U;
+        for (uint64_t i = 0U; i < ops; i++) {
+            acc += get_sensor_count(find_machine(static_cast<uint16_t>(i % machines)));
+        }
+        sink += acc;
+    });
+    record("wrapper_find_machine", "ns/op", findMachineNs);
+
+    double findSensorNs = timeNsPerOp(ops, [&] {
+        uint32_t acc = 0U;
+        for (uint64_t i = 0U; i < ops; i++) {
+            acc += find_sensor_slot(sensor_layout.number[i % sensors]);
+        }
+        sink += acc;
+    });
+    record("wrapper_find_sensor_slot", "ns/op", findSensorNs);
+}
+
+/**
+ * @brief Range-check kernel throughput, vector path against the scalar reference.
+*/
+static void benchDetection(uint64_t samples)
+{
+    const uint32_t channels = 4096U;
+    std::vector<float> value(channels), min(channels), max(channels);
+    std::vector<pm_value_t> pmValue(channels), pmMin(channels), pmMax(channels);
+    std::vector<uint32_t> mask(DETECT_MASK_WORDS(channels));
+
+    for (uint32_t i = 0U; i < channels; i++) {
+        min[i]   = 10.0f;
+        max[i]   = 20.0f;
+        value[i] = 5.0f + 20.0f * nextUniform();     // About 40 % out of range
+        pmMin[i]   = pm_value_from_float(min[i]);
+        pmMax[i]   = pm_value_from_float(max[i]);
+        pmValue[i] = pm_value_from_float(value[i]);
+    }
+
+    uint64_t rounds = samples / channels;
+    double simdNs = timeNsPerOp(rounds * channels, [&] {
+        for (uint64_t r = 0U; r < rounds; r++) {
+            sink += detect_out_of_range(pmValue.data(), pmMin.data(), pmMax.data(), channels, mask.data());
+        }
+    });
+    double scalarNs = timeNsPerOp(rounds * channels, [&] {
+        for (uint64_t r = 0U; r < rounds; r++) {
+            sink += detect_out_of_range_scalar(value.data(), min.data(), max.data(), channels, mask.data());
+        }
+    });
+    record("detect_out_of_range", "samples/s", 1e9 / simdNs);
+    record("detect_out_of_range_scalar", "samples/s", 1e9 / scalarNs);
+}
+
+/**
+ * @brief Cost of one vibration spectrum (window, FFT, band energies).
+*/
+static void benchSpectrum(uint32_t frames)
+{
+    static float frame[SPECTRUM_FFT_SIZE];
+    const spectrum_config_t cfg = { 1000.0f, 29.5f, 180.0f, 260.0f };
+    spectrum_features_t features;
+
+    for (uint32_t i = 0U; i < SPECTRUM_FFT_SIZE; i++) {
+        frame[i] = sinf(2.0f * 3.14159265f * 29.5f * static_cast<float>(i) / 1000.0f) + 0.1f * nextUniform();
+    }
+
+    double ns = timeNsPerOp(frames, [&] {
+        for (uint32_t f = 0U; f < frames; f++) {
+            (void)spectrum_analyze(frame, &cfg, &features);
+            sink += static_cast<uint32_t>(features.peak_hz);
+        }
+    });
+    record("spectrum_analyze", "us/frame", ns / 1000.0);
+}
+
+/**
+ * @brief Cost of the instrumentation hooks when compiled in.
+*/
+static void benchInstrumentation(uint64_t ops)
+{
+    double recordNs = timeNsPerOp(ops, [&] {
+        for (uint64_t i = 0U; i < ops; i++) {
+            instr_record(INSTR_STAGE_DETECT, static_cast<uint32_t>(i & 0x3FFU));
+        }
+    });
+    record("instr_record", "ns/op", recordNs);
+
+    double hookNs = timeNsPerOp(ops, [&] {
+        for (uint64_t i = 0U; i < ops; i++) {
+            INSTR_BEGIN(t);
+            INSTR_END(INSTR_STAGE_ENQUEUE, t);
+        }
+    });
+    record("instr_begin_end", "ns/op", hookNs);
+}
+
+/**
+ * @brief Compressed history: append and decode cost, and compression of a
+ *        slowly varying 1 Hz channel (0.1 degree steps) against raw readings.
+*/
+static void benchHistory(uint64_t samples)
+{
+    static history_t h;
+    history_init(&h);
+
+    float value = 80.0f;
+    double appendNs = timeNsPerOp(samples, [&] {
+        for (uint64_t i = 0U; i < samples; i++) {
+            if (nextUniform() < 0.25f) {
+                value += (nextUniform() < 0.5f) ? 0.1f : -0.1f;
+            }
+            history_append(&h, static_cast<uint32_t>(i) * 1000U, pm_value_from_float(roundf(value * 10.0f) / 10.0f));
+        }
+    });
+    record("history_append", "ns/sample", appendNs);
+
+    history_usage_t u;
+    history_usage(&h, &u);
+    record("history_compression", "x vs sensor_reading",
+           static_cast<double>(u.samples) * sizeof(struct sensor_reading) / static_cast<double>(u.bytes));
+    record("history_samples_held", "samples/sensor", static_cast<double>(u.samples));
+
+    history_iter_t it;
+    uint32_t t;
+    pm_value_t v;
+    uint32_t decoded = 0U;
+    double iterNs = timeNsPerOp(u.samples, [&] {
+        history_iter_init(&it, &h, 0U, UINT32_MAX);
+        while (history_iter_next(&it, &t, &v)) {
+            decoded++;
+        }
+    });
+    record("history_iterate", "ns/sample", iterNs);
+
+    // Last tenth of the held range - earlier blocks are skipped undecoded
+    uint32_t end = static_cast<uint32_t>(samples - 1U) * 1000U;
+    uint32_t from = end - (u.samples / 10U) * 1000U;
+    double rangeNs = timeNsPerOp(1000U, [&] {
+        for (uint32_t i = 0U; i < 1000U; i++) {
+            history_iter_init(&it, &h, from, end);
+            while (history_iter_next(&it, &t, &v)) {
+                decoded++;
+            }
+        }
+    });
+    record("history_range_query", "us/query", rangeNs / 1000.0);
+    sink = decoded;
+}
+
+/**
+ * @brief Rollup aggregation cost per sample, and how many raw samples each
+ *        emitted record replaces on a 1 kHz channel.
+*/
+static void benchRollup(uint64_t samples)
+{
+    static sensor_rollup_t r;
+    rollup_init(&r);
+
+    rollup_record_t closed[ROLLUP_MAX_CLOSED];
+    uint64_t emitted[ROLLUP_LEVELS] = { 0U, 0U, 0U };
+    double pushNs = timeNsPerOp(samples, [&] {
+        for (uint64_t i = 0U; i < samples; i++) {
+            uint32_t n = rollup_push(&r, static_cast<uint32_t>(i), pm_value_from_float(nextUniform()), closed);
+            for (uint32_t k = 0U; k < n; k++) {
+                emitted[closed[k].level]++;
+            }
+        }
+    });
+    record("rollup_push", "ns/sample", pushNs);
+    record("rollup_reduction_1s", "samples/record",
+           (emitted[ROLLUP_1S] > 0U) ? static_cast<double>(samples) / emitted[ROLLUP_1S] : 0.0);
+    record("rollup_reduction_1min", "samples/record",
+           (emitted[ROLLUP_1M] > 0U) ? static_cast<double>(samples) / emitted[ROLLUP_1M] : 0.0);
+}
+
+/**
+ * @brief Flash history: append cost including flash programming, write
+ *        amplification, and seek/scan speed, on the RAM-backed flash shim.
+*/
+static void benchStore(uint64_t records)
+{
+    if (store_init() != 0) {
+        fprintf(stderr, "store_init failed\n");
+        return;
+    }
+
+    // One reading per ms, flushed to flash as soon as a page fills
+    double appendNs = timeNsPerOp(records, [&] {
+        for (uint64_t i = 0U; i < records; i++) {
+            struct sensor_reading r = { static_cast<uint32_t>(i), pm_value_from_float(nextUniform()),
+                                        static_cast<uint16_t>(i % 6U), static_cast<uint16_t>(i) };
+            (void)store_append(&r);
+            (void)store_service();
+        }
+    });
+    record("store_append", "ns/record", appendNs);
+
+    store_stats_t st;
+    flash_sim_stats_t fs;
+    store_get_stats(&st);
+    flash_sim_get_stats(&fs);
+    double payload = static_cast<double>(st.pages_written) * STORE_PAGE_RECORDS * sizeof(struct sensor_reading);
+    record("store_write_amplification", "flash bytes/payload byte", static_cast<double>(fs.bytes_written) / payload);
+    record("store_dropped", "records", static_cast<double>(st.dropped));
+
+    // Seek to the middle of what the ring still holds, then scan to the end
+    static store_cursor_t cursor;
+    uint32_t target = static_cast<uint32_t>(records - (records / 16U));
+    double seekNs = timeNsPerOp(1000U, [&] {
+        for (uint32_t i = 0U; i < 1000U; i++) {
+            (void)store_seek(&cursor, target);
+        }
+    });
+    record("store_seek", "us/op", seekNs / 1000.0);
+
+    uint64_t scanned = 0U;
+    struct sensor_reading out;
+    double scanNs = timeNsPerOp(1U, [&] {
+        (void)store_seek(&cursor, 0U);
+        while (store_next(&cursor, &out) == 0) {
+            scanned++;
+        }
+    });
+    record("store_scan", "M records/s", (scanNs > 0.0) ? (static_cast<double>(scanned) * 1000.0 / scanNs) : 0.0);
+    sink = static_cast<uint32_t>(scanned);
+}
+
+/**
+ * @brief Signal generator throughput per model, and over a mixed fleet of
+ *        10,000 channels sampled round-robin.
+*/
+static void benchSimulator(uint64_t samples)
+{
+    static const struct {
+        const char* name;
+        sim_model_t model;
+        uint32_t    periodMs;
+    } models[] = {
+        { "sim_sample_thermal",   SIM_MODEL_THERMAL,   1000U },
+        { "sim_sample_pressure",  SIM_MODEL_PRESSURE,  100U },
+        { "sim_sample_vibration", SIM_MODEL_VIBRATION, 1U },
+    };
+
+    static pm_value_t out[1024];
+    const uint32_t block = sizeof(out) / sizeof(out[0]);
+    uint64_t rounds = samples / block;
+
+    for (const auto& m : models) {
+        sim_channel_t ch;
+        sim_init(&ch, m.model, PM_VALUE(60.0f), PM_VALUE(100.0f), 1U);
+        double ns = timeNsPerOp(rounds * block, [&] {
+            uint32_t t = 0U;
+            for (uint64_t r = 0U; r < rounds; r++) {
+                sim_fill(&ch, t, m.periodMs, out, block);
+                t += block * m.periodMs;
+                sink += static_cast<uint32_t>(out[block - 1U]);
+            }
+        });
+        record(m.name, "samples/s", 1e9 / ns);
+    }
+
+    const uint32_t channels = 10000U;
+    std::vector<sim_channel_t> fleet(channels);
+    for (uint32_t i = 0U; i < channels; i++) {
+        sim_init(&fleet[i], static_cast<sim_model_t>(i % 3U), PM_VALUE(60.0f), PM_VALUE(100.0f), i + 1U);
+    }
+    uint64_t sweeps = (samples + channels - 1U) / channels;
+    double fleetNs = timeNsPerOp(sweeps * channels, [&] {
+        pm_value_t acc = 0;
+        for (uint64_t r = 0U; r < sweeps; r++) {
+            for (uint32_t i = 0U; i < channels; i++) {
+                acc += sim_sample(&fleet[i], static_cast<uint32_t>(r));
+            }
+        }
+        sink += static_cast<uint32_t>(acc);
+    });
+    record("sim_sample_fleet", "samples/s", 1e9 / fleetNs, channels);
+}
+
+/**
+ * @brief Acquisition-to-detection throughput for a fleet of the given size.
+*/
+static void benchPipeline(uint32_t sensors, uint64_t samples)
+{
+    static CircularBuffer cb;
+    std::vector<pm_value_t> min(sensors), max(sensors);
+    std::vector<sensor_stats_t> stats(sensors);
+    std::vector<sensor_window_t> windows(sensors);
+
+    // Batch gathered from one ring span (as in anomaly_detect)
+    pm_value_t value[BUFFER_SIZE], lo[BUFFER_SIZE], hi[BUFFER_SIZE];
+    uint16_t   slot[BUFFER_SIZE];
+    uint32_t mask[DETECT_MASK_WORDS(BUFFER_SIZE)];
+    uint32_t flagged = 0U;
+
+    for (uint32_t s = 0U; s < sensors; s++) {
+        min[s] = PM_VALUE(60.0f);
+        max[s] = PM_VALUE(100.0f);
+        stats_init(&stats[s], STATS_EWMA_ALPHA);
+        window_init(&windows[s]);
+    }
+    circular_buffer_init(&cb, CB_OVERWRITE_OLDEST);
+    cb_reader_t* reader = cb_reader_register(&cb, "detect", nullptr);
+
+    auto drain = [&] {
+        const struct sensor_reading* span;
+        uint32_t count;
+        while ((count = cb_read_peek(&cb, reader, &span)) > 0U) {
+            for (uint32_t i = 0U; i < count; i++) {
+                value[i] = span[i].value;
+                slot[i]  = span[i].sensor_id;
+                lo[i]    = min[slot[i]];
+                hi[i]    = max[slot[i]];
+            }
+            (void)cb_read_release(&cb, reader, count);
+
+            flagged += detect_out_of_range(value, lo, hi, count, mask);
+            for (uint32_t i = 0U; i < count; i++) {
+                pm_value_t z = stats_update(&stats[slot[i]], value[i]);
+                window_push(&windows[slot[i]], value[i]);
+                flagged += stats_is_outlier(&stats[slot[i]], z, STATS_Z_THRESHOLD) ? 1U : 0U;
+            }
+        }
+    };
+
+    uint64_t rounds = (samples + sensors - 1U) / sensors;
+    double ns = timeNsPerOp(rounds * sensors, [&] {
+        for (uint64_t r = 0U; r < rounds; r++) {
+            for (uint32_t s = 0U; s < sensors; s++) {
+                struct sensor_reading* reading = cb_write_reserve(&cb);
+                reading->timestamp_ms = static_cast<uint32_t>(r);
+                reading->value        = pm_value_from_float(55.0f + 50.0f * nextUniform());
+                reading->sensor_id    = static_cast<uint16_t>(s);
+                reading->seq          = static_cast<uint16_t>(s);
+                cb_write_commit(&cb);
+
+                if (cb_lag(&cb, reader) >= BUFFER_HIGH_WATER) {
+                    drain();
+                }
+            }
+            drain();
+        }
+    });
+    sink += flagged;
+
+    record("pipeline", "samples/s", 1e9 / ns, sensors);
+}
+
+
+static bool writeJson(FILE* out)
+{
+    fprintf(out, "{\n  \"suite\": \"edge_pm\",\n  \"detect_impl\": \"%s\",\n", detect_impl_name());
+    fprintf(out, "  \"buffer_size\": %u,\n  \"results\": [\n", BUFFER_SIZE);
+    for (size_t i = 0U; i < results.size(); i++) {
+        const Result& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.3f", r.name.c_str(), r.unit.c_str(),
+                r.value);
+        if (r.sensors != 0U) {
+            fprintf(out, ", \"sensors\": %u", r.sensors);
+        }
+        fprintf(out, "}%s\n", (i + 1U < results.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    return ferror(out) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* outPath = nullptr;
+    uint64_t scale = 10U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            scale = 1U;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [-o results.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    benchCircularBuffer(scale * 1000000U);
+    benchWrapper(scale * 1000000U);
+    benchDetection(scale * 10000000U);
+    benchSpectrum(static_cast<uint32_t>(scale * 100U));
+    benchInstrumentation(scale * 1000000U);
+    benchHistory(scale * 100000U);
+    benchRollup(scale * 1000000U);
+    benchStore(scale * 100000U);
+    benchSimulator(scale * 1000000U);
+    for (uint32_t sensors : fleetSizes) {
+        benchPipeline(sensors, scale * 1000000U);
+    }
+
+    FILE* out = (outPath != nullptr) ? fopen(outPath, "w") : stdout;
+    if (out == nullptr) {
+        perror(outPath);
+        return 1;
+    }
+    bool ok = writeJson(out);
+    if (out != stdout) {
+        ok = (fclose(out) == 0) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file autoconf.h
+ * @brief Host stand-in for Zephyr's generated configuration.
+ *
+ * Mirrors the defaults of the application Kconfig so the host build sees
+ * the same capacities as the target.
+*/
+
+#ifndef BENCH_AUTOCONF_H
+#define BENCH_AUTOCONF_H
+
+#define CONFIG_PM_MAX_MACHINES              3
+#define CONFIG_PM_MAX_SENSORS_PER_MACHINE   3
+#define CONFIG_PM_MAX_TEMP_SENSORS          3
+#define CONFIG_PM_MAX_PRESS_SENSORS         2
+#define CONFIG_PM_MAX_VIB_SENSORS           1
+#define CONFIG_PM_SCHED_MAX_ENTRIES         64
+#define CONFIG_PM_HISTORY_BLOCK_SIZE        128
+#define CONFIG_PM_HISTORY_BLOCKS            16
+#define CONFIG_PM_STORE_PAGE_SIZE           512
+#define CONFIG_PM_STORE_SEGMENT_SIZE        4096
+#define CONFIG_PM_STORE_PAGE_BUFFERS        4
+
+#endif // BENCH_AUTOCONF_H
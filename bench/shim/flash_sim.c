@@ -0,0 +1,102 @@
+/**
+ * @file flash_sim.c
+ * @brief RAM-backed flash behind the flash map shim, and the CRC-32 helpers.
+*/
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+static uint8_t flash[FLASH_SIM_SIZE];
+static const struct flash_area area = { 0U, 0, FLASH_SIM_SIZE };
+static flash_sim_stats_t stats;
+static int erased_once;
+
+static int in_range(off_t off, size_t len)
+{
+    return off >= 0 && (size_t)off <= FLASH_SIM_SIZE && len <= FLASH_SIM_SIZE - (size_t)off;
+}
+
+int flash_area_open(uint8_t id, const struct flash_area **fa)
+{
+    if (id != 0U || fa == NULL) {
+        return -ENOENT;
+    }
+    if (!erased_once) {
+        memset(flash, 0xFF, sizeof(flash));
+        erased_once = 1;
+    }
+    *fa = &area;
+    return 0;
+}
+
+void flash_area_close(const struct flash_area *fa)
+{
+    (void)fa;
+}
+
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len)
+{
+    (void)fa;
+    if (!in_range(off, len)) {
+        return -EINVAL;
+    }
+    memcpy(dst, &flash[off], len);
+    return 0;
+}
+
+int flash_area_write(const struct flash_area *fa, off_t off, const void *src, size_t len)
+{
+    (void)fa;
+    if (!in_range(off, len)) {
+        return -EINVAL;
+    }
+    const uint8_t *s = (const uint8_t *)src;
+    for (size_t i = 0U; i < len; i++) {
+        flash[(size_t)off + i] &= s[i];         // NOR: programming only clears bits
+    }
+    stats.bytes_written += len;
+    return 0;
+}
+
+int flash_area_erase(const struct flash_area *fa, off_t off, size_t len)
+{
+    (void)fa;
+    if (!in_range(off, len) || ((size_t)off % FLASH_SIM_ERASE_BLOCK) != 0U ||
+        (len % FLASH_SIM_ERASE_BLOCK) != 0U) {
+        return -EINVAL;
+    }
+    memset(&flash[off], 0xFF, len);
+    stats.bytes_erased += len;
+    return 0;
+}
+
+uint8_t flash_area_erased_val(const struct flash_area *fa)
+{
+    (void)fa;
+    return 0xFFU;
+}
+
+void flash_sim_get_stats(flash_sim_stats_t *out)
+{
+    *out = stats;
+}
+
+uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    for (size_t i = 0U; i < len; i++) {
+        crc ^= data[i];
+        for (uint32_t b = 0U; b < 8U; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t crc32_ieee(const uint8_t *data, size_t len)
+{
+    return crc32_ieee_update(0U, data, len);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file kernel.h
+ * @brief Host shim for the subset of the Zephyr kernel API the data path uses.
+ *
+ * Kernel objects are inert: the benchmarks drive the data path from a
+ * single thread, so queues accept and drop messages and locks never block.
+*/
+
+#ifndef BENCH_SHIM_KERNEL_H
+#define BENCH_SHIM_KERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/barrier.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct { int64_t ticks; } k_timeout_t;
+
+#define K_NO_WAIT   ((k_timeout_t){0})
+#define K_FOREVER   ((k_timeout_t){-1})
+#define K_MSEC(ms)  ((k_timeout_t){(ms)})
+
+struct k_msgq  { int unused; };
+struct k_mutex { int unused; };
+struct k_sem   { int unused; };
+struct k_thread { int unused; };
+struct k_spinlock { int unused; };
+
+typedef int k_spinlock_key_t;
+
+#define K_SEM_DEFINE(name, initial, limit)  struct k_sem name
+
+static inline int k_msgq_put(struct k_msgq *q, const void *data, k_timeout_t timeout)
+{
+    (void)q; (void)data; (void)timeout;
+    return 0;
+}
+
+static inline int k_mutex_lock(struct k_mutex *m, k_timeout_t timeout)
+{
+    (void)m; (void)timeout;
+    return 0;
+}
+
+static inline int k_mutex_unlock(struct k_mutex *m)
+{
+    (void)m;
+    return 0;
+}
+
+static inline void k_sem_give(struct k_sem *s)
+{
+    (void)s;
+}
+
+static inline int k_sem_take(struct k_sem *s, k_timeout_t timeout)
+{
+    (void)s; (void)timeout;
+    return 0;
+}
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
+{
+    (void)l;
+    return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key)
+{
+    (void)l; (void)key;
+}
+
+static inline uint32_t k_uptime_get_32(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U);
+}
+
+/** @brief Cycle counter - nanoseconds on the host */
+static inline uint32_t k_cycle_get_32(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cycles)
+{
+    return cycles / 1000U;
+}
+
+#define printk printf
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_SHIM_KERNEL_H
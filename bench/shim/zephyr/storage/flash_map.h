@@ -0,0 +1,55 @@
+/**
+ * @file flash_map.h
+ * @brief Host shim for the Zephyr flash map API on a RAM-backed flash.
+ *
+ * One partition of FLASH_SIM_SIZE bytes that behaves like NOR flash:
+ * erase sets bytes to 0xFF, programming can only clear bits. Counters
+ * of programmed and erased bytes let the benchmarks measure write
+ * amplification.
+*/
+
+#ifndef BENCH_SHIM_FLASH_MAP_H
+#define BENCH_SHIM_FLASH_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of the simulated partition */
+#define FLASH_SIM_SIZE              (256U * 1024U)
+
+/** @brief Erase granularity of the simulated flash */
+#define FLASH_SIM_ERASE_BLOCK       4096U
+
+#define FIXED_PARTITION_ID(label)   0
+
+struct flash_area {
+    uint8_t fa_id;
+    off_t   fa_off;
+    size_t  fa_size;
+};
+
+/** @brief Bytes programmed and erased since start-up */
+typedef struct {
+    uint64_t bytes_written;
+    uint64_t bytes_erased;
+} flash_sim_stats_t;
+
+int flash_area_open(uint8_t id, const struct flash_area **fa);
+void flash_area_close(const struct flash_area *fa);
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len);
+int flash_area_write(const struct flash_area *fa, off_t off, const void *src, size_t len);
+int flash_area_erase(const struct flash_area *fa, off_t off, size_t len);
+uint8_t flash_area_erased_val(const struct flash_area *fa);
+
+void flash_sim_get_stats(flash_sim_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_SHIM_FLASH_MAP_H
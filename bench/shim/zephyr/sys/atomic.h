@@ -0,0 +1,73 @@
+/**
+ * @file atomic.h
+ * @brief Host shim for Zephyr atomics on top of the GCC/Clang builtins.
+*/
+
+#ifndef BENCH_SHIM_ATOMIC_H
+#define BENCH_SHIM_ATOMIC_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef long atomic_t;
+typedef atomic_t atomic_val_t;
+
+#define ATOMIC_INIT(i)          (i)
+#define ATOMIC_BITS             (sizeof(atomic_val_t) * 8U)
+#define ATOMIC_BITMAP_SIZE(n)   (((n) + ATOMIC_BITS - 1U) / ATOMIC_BITS)
+
+static inline atomic_val_t atomic_get(const atomic_t *target)
+{
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value)
+{
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_add(atomic_t *target, atomic_val_t value)
+{
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t *target)
+{
+    return atomic_add(target, 1);
+}
+
+static inline atomic_val_t atomic_or(atomic_t *target, atomic_val_t value)
+{
+    return __atomic_fetch_or(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool atomic_cas(atomic_t *target, atomic_val_t old_value, atomic_val_t new_value)
+{
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_clear(atomic_t *target)
+{
+    return atomic_set(target, 0);
+}
+
+static inline void atomic_set_bit(atomic_t *target, int bit)
+{
+    (void)atomic_or(&target[bit / ATOMIC_BITS], 1L << (bit % ATOMIC_BITS));
+}
+
+static inline bool atomic_test_and_set_bit(atomic_t *target, int bit)
+{
+    atomic_val_t mask = 1L << (bit % ATOMIC_BITS);
+    return (atomic_or(&target[bit / ATOMIC_BITS], mask) & mask) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_SHIM_ATOMIC_H
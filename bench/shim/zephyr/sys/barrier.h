@@ -0,0 +1,14 @@
+/**
+ * @file barrier.h
+ * @brief Host shim for Zephyr memory barriers.
+*/
+
+#ifndef BENCH_SHIM_BARRIER_H
+#define BENCH_SHIM_BARRIER_H
+
+static inline void barrier_dmem_fence_full(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif // BENCH_SHIM_BARRIER_H
@@ -0,0 +1,23 @@
+/**
+ * @file crc.h
+ * @brief Host shim for the Zephyr CRC-32 (IEEE 802.3) helpers.
+*/
+
+#ifndef BENCH_SHIM_CRC_H
+#define BENCH_SHIM_CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t crc32_ieee(const uint8_t *data, size_t len);
+uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_SHIM_CRC_H
@@ -0,0 +1,20 @@
+/**
+ * @file util.h
+ * @brief Host shim for the Zephyr utility macros.
+*/
+
+#ifndef BENCH_SHIM_UTIL_H
+#define BENCH_SHIM_UTIL_H
+
+#ifdef __cplusplus
+#define BUILD_ASSERT(cond, msg)     static_assert(cond, msg)
+#else
+#define BUILD_ASSERT(cond, msg)     _Static_assert(cond, msg)
+#endif
+
+#define ARRAY_SIZE(array)       (sizeof(array) / sizeof((array)[0]))
+#define MIN(a, b)               (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)               (((a) > (b)) ? (a) : (b))
+#define IS_POWER_OF_TWO(x)      (((x) != 0U) && (((x) & ((x) - 1U)) == 0U))
+
+#endif // BENCH_SHIM_UTIL_H
@@ -0,0 +1,301 @@
+/**
+ * @file test_main.cpp
+ * @brief Host correctness checks of the edge_pm data path.
+ *
+ * Registered with CTest and run after every build of the host suite, so
+ * a regression fails the build instead of hiding in a benchmark report:
+ *  - pm_test_q16: the Q16.16 data path (CONFIG_PM_FIXED_POINT) against a
+ *    float/double reference on the same inputs
+ *  - pm_test, pm_test_q16: detection of faults injected into simulated
+ *    channels
+ *
+ * Measured deviations and detection delays are printed; the exit status
+ * is non-zero if any check fails.
+ *
+ * Usage: pm_test [samples]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <vector>
+
+// Core modules are plain C without C++ guards
+extern "C" {
+#include "fixed_point.h"
+#include "detection.h"
+#include "statistics.h"
+#include "window.h"
+#include "rollup.h"
+#include "simulator.h"
+}
+
+static void report(const char* name, const char* unit, double value)
+{
+    printf("%-28s %10.3f %s\n", name, value, unit);
+}
+
+/**
+ * @brief Detection of known faults injected into simulated channels.
+ *
+ * Each channel runs healthy for a minute, then carries one fault, and its
+ * samples go through the stages that should catch it: the range check
+ * for a ramp and a spike, the z-score test for a spike, and a collapsed
+ * sliding window (min == max over a full window) for a stuck sensor - a
+ * criterion the detection thread does not apply yet. The delay from
+ * fault onset to the first flag is reported.
+ *
+ * @return true if every fault was flagged and no healthy sample left its range
+*/
+static bool checkSimulatedFaults()
+{
+    static const struct {
+        const char* name;
+        sim_model_t model;
+        float       min;
+        float       max;
+        uint32_t    periodMs;
+        sim_fault_t fault;
+    } cases[] = {
+        { "sim_ramp_detect_delay",  SIM_MODEL_THERMAL,   60.0f, 100.0f, 1000U,
+          { 60000U, 120000U, Q16_CONST(40.0f), SIM_FAULT_RAMP } },
+        { "sim_spike_detect_delay", SIM_MODEL_PRESSURE,  87.0f, 360.0f, 100U,
+          { 60000U, 500U, Q16_CONST(200.0f), SIM_FAULT_SPIKE } },
+        { "sim_stuck_detect_delay", SIM_MODEL_VIBRATION, 0.5f, 2.0f, 1U,
+          { 60000U, 30000U, 0, SIM_FAULT_STUCK } },
+    };
+
+    bool ok = true;
+    for (const auto& c : cases) {
+        static sim_channel_t   ch;
+        static sensor_window_t w;
+        sensor_stats_t st;
+        pm_value_t lo = pm_value_from_float(c.min);
+        pm_value_t hi = pm_value_from_float(c.max);
+
+        sim_init(&ch, c.model, lo, hi, 1U);
+        sim_inject(&ch, &c.fault);
+        stats_init(&st, STATS_EWMA_ALPHA);
+        window_init(&w);
+
+        uint32_t healthyFlags = 0U;
+        bool     detected     = false;
+        uint32_t delay        = 0U;
+        uint32_t end          = c.fault.start_ms + c.fault.duration_ms;
+
+        for (uint32_t t = 0U; t < end && !detected; t += c.periodMs) {
+            pm_value_t v = sim_sample(&ch, t);
+            uint32_t   mask;
+            bool range   = detect_out_of_range(&v, &lo, &hi, 1U, &mask) != 0U;
+            bool outlier = stats_is_outlier(&st, stats_update(&st, v), STATS_Z_THRESHOLD);
+            window_push(&w, v);
+            bool flat    = (window_length(&w) == WINDOW_SIZE) && (window_min(&w) == window_max(&w));
+
+            if (!sim_fault_active(&ch, t)) {
+                healthyFlags += (range || flat) ? 1U : 0U;
+                continue;
+            }
+            switch (c.fault.kind) {
+            case SIM_FAULT_STUCK:
+                detected = flat;
+                break;
+            case SIM_FAULT_SPIKE:
+                detected = range || outlier;
+                break;
+            default:
+                detected = range;
+                break;
+            }
+            delay = t - c.fault.start_ms;
+        }
+
+        report(c.name, "ms", detected ? static_cast<double>(delay) : -1.0);
+        if (!detected || healthyFlags != 0U) {
+            fprintf(stderr, "%s: fault %s, %u healthy samples flagged\n", c.name,
+                    detected ? "detected" : "missed", healthyFlags);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+#ifdef CONFIG_PM_FIXED_POINT
+/** @brief xorshift32 - cheap, deterministic test data */
+static uint32_t rngState = 0x9E3779B9U;
+
+static float nextUniform()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Sample on a 1/256 grid - exact both in float and in Q16.16.
+*/
+static float nextGridValue(float lo, float span)
+{
+    return roundf((lo + span * nextUniform()) * 256.0f) / 256.0f;
+}
+
+/**
+ * @brief Q16.16 data path against a float/double reference on the same inputs.
+ *
+ * Inputs lie on the Q16.16 grid, so range checks and order statistics
+ * (min, max, last, count) must match exactly; means, RMS, deviations and
+ * z-scores may differ by rounding only. The largest deviations are
+ * reported, and the run fails if any result is out of tolerance.
+ *
+ * @return true if the fixed-point results match the reference
+*/
+static bool checkFixedPoint(uint32_t samples)
+{
+    bool ok = true;
+
+    // Range check, including values exactly on the bounds
+    const uint32_t channels = 4096U;
+    std::vector<float> value(channels), min(channels), max(channels);
+    std::vector<q16_t> qValue(channels), qMin(channels), qMax(channels);
+    std::vector<uint32_t> mask(DETECT_MASK_WORDS(channels)), qMask(DETECT_MASK_WORDS(channels));
+
+    for (uint32_t i = 0U; i < channels; i++) {
+        min[i]   = nextGridValue(-50.0f, 100.0f);
+        max[i]   = min[i] + nextGridValue(0.0f, 50.0f);
+        value[i] = ((i % 8U) == 0U) ? min[i] : (((i % 8U) == 1U) ? max[i] : nextGridValue(-60.0f, 170.0f));
+        qMin[i]   = q16_from_float(min[i]);
+        qMax[i]   = q16_from_float(max[i]);
+        qValue[i] = q16_from_float(value[i]);
+    }
+    uint32_t flagged  = detect_out_of_range_scalar(value.data(), min.data(), max.data(), channels, mask.data());
+    uint32_t qFlagged = detect_out_of_range(qValue.data(), qMin.data(), qMax.data(), channels, qMask.data());
+    if (flagged != qFlagged || mask != qMask) {
+        fprintf(stderr, "q16 range check differs from float (%u vs %u flagged)\n", qFlagged, flagged);
+        ok = false;
+    }
+
+    // Window, rollup and statistics fed the same stream
+    static sensor_window_t w;
+    static sensor_rollup_t r;
+    sensor_stats_t st;
+    window_init(&w);
+    rollup_init(&r);
+    stats_init(&st, STATS_EWMA_ALPHA);
+
+    double ring[WINDOW_SIZE];
+    double mean = 0.0, m2 = 0.0;
+    uint32_t rCount = 0U, rStart = 0U, orderErrors = 0U;
+    double rMin = 0.0, rMax = 0.0, rSum = 0.0, rLast = 0.0;
+    double meanErr = 0.0, rmsErr = 0.0, sdErr = 0.0, zErr = 0.0;
+    rollup_record_t closed[ROLLUP_MAX_CLOSED];
+
+    for (uint32_t i = 0U; i < samples; i++) {
+        float    f  = nextGridValue(55.0f, 50.0f);
+        q16_t    q  = q16_from_float(f);
+        uint32_t ts = i * 10U;
+
+        // Window against a direct recomputation over the last WINDOW_SIZE samples
+        ring[i % WINDOW_SIZE] = f;
+        window_push(&w, q);
+        uint32_t n = (i + 1U < WINDOW_SIZE) ? (i + 1U) : WINDOW_SIZE;
+        double lo = ring[0], hi = ring[0], sum = 0.0, sq = 0.0;
+        for (uint32_t k = 0U; k < n; k++) {
+            lo   = fmin(lo, ring[k]);
+            hi   = fmax(hi, ring[k]);
+            sum += ring[k];
+            sq  += ring[k] * ring[k];
+        }
+        if (window_min(&w) != q16_from_float(static_cast<float>(lo)) ||
+            window_max(&w) != q16_from_float(static_cast<float>(hi))) {
+            orderErrors++;
+        }
+        meanErr = fmax(meanErr, fabs(q16_to_float(window_mean(&w)) - sum / n));
+        rmsErr  = fmax(rmsErr, fabs(q16_to_float(window_rms(&w)) - sqrt(sq / n)));
+
+        // 1 s rollup: the record of the previous second closes with this sample
+        uint32_t start = ts - (ts % 1000U);
+        uint32_t nClosed = rollup_push(&r, ts, q, closed);
+        if (start != rStart && rCount > 0U) {
+            bool seen = false;
+            for (uint32_t k = 0U; k < nClosed; k++) {
+                const rollup_record_t& c = closed[k];
+                if (c.level != ROLLUP_1S) {
+                    continue;
+                }
+                seen = true;
+                if (c.start_ms != rStart || c.count != rCount ||
+                    c.min != q16_from_float(static_cast<float>(rMin)) ||
+                    c.max != q16_from_float(static_cast<float>(rMax)) ||
+                    c.last != q16_from_float(static_cast<float>(rLast))) {
+                    orderErrors++;
+                }
+                meanErr = fmax(meanErr, fabs(q16_to_float(c.mean) - rSum / rCount));
+            }
+            orderErrors += seen ? 0U : 1U;
+            rCount = 0U;
+        }
+        if (rCount == 0U) {
+            rStart = start;
+            rMin   = f;
+            rMax   = f;
+            rSum   = 0.0;
+        }
+        rMin  = fmin(rMin, f);
+        rMax  = fmax(rMax, f);
+        rSum += f;
+        rLast = f;
+        rCount++;
+
+        // Welford statistics; z-score against the state before the sample
+        double sd = (i >= 2U) ? sqrt(m2 / (i - 1U)) : 0.0;
+        double z  = (sd > 0.0) ? (f - mean) / sd : 0.0;
+        double zq = q16_to_float(stats_update(&st, q));
+        double delta = f - mean;
+        mean += delta / (i + 1U);
+        m2   += delta * (f - mean);
+        if (i >= STATS_WARMUP_SAMPLES) {
+            zErr = fmax(zErr, fabs(zq - z));
+        }
+        meanErr = fmax(meanErr, fabs(q16_to_float(stats_mean(&st)) - mean));
+        if (i >= 1U) {
+            sdErr = fmax(sdErr, fabs(q16_to_float(stats_stddev(&st)) - sqrt(m2 / i)));
+        }
+    }
+
+    report("q16_order_stat_mismatches", "count", static_cast<double>(orderErrors));
+    report("q16_max_error_mean", "LSB", meanErr * Q16_ONE);
+    report("q16_max_error_rms", "LSB", rmsErr * Q16_ONE);
+    report("q16_max_error_stddev", "LSB", sdErr * Q16_ONE);
+    report("q16_max_error_zscore", "LSB", zErr * Q16_ONE);
+
+    // Means are rounded once; roots truncate, and the z-score divides by one
+    if (orderErrors != 0U || meanErr * Q16_ONE > 1.0 || rmsErr * Q16_ONE > 2.0 ||
+        sdErr * Q16_ONE > 2.0 || zErr * Q16_ONE > 4.0) {
+        fprintf(stderr, "q16 statistics out of tolerance\n");
+        ok = false;
+    }
+    return ok;
+}
+#endif  // CONFIG_PM_FIXED_POINT
+
+int main(int argc, char** argv)
+{
+    uint32_t samples = 1000000U;
+
+    if (argc > 2 || (argc == 2 && (samples = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10))) == 0U)) {
+        fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+        return 2;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    bool ok = checkFixedPoint(samples);
+#else
+    bool ok = true;
+    (void)samples;
+#endif
+    ok = checkSimulatedFaults() && ok;
+
+    return ok ? 0 : 1;
+}
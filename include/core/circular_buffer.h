@@ -3,36 +3,102 @@
 
 /**
 * @file circular_buffer.h
-* @brief Circular buffer interface for storing sensor data.
+* @brief Lock-free single-producer/multi-reader broadcast ring for sensor data.
 */
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <zephyr/sys/atomic.h>
 
 #include "shared_resources.h"
 
-/** @brief Max number of sensor data entries held in the circular buffer. */
-#define BUFFER_SIZE     12U
+/** @brief Max number of sensor data entries held in the circular buffer (power of two). */
+#define BUFFER_SIZE     64U
+
+/** @brief Index mask replacing the modulo on every head/tail wrap. */
+#define BUFFER_MASK     (BUFFER_SIZE - 1U)
+
+/** @brief Unread entries at which the producer pauses mid-sweep until its readers catch up. */
+#define BUFFER_HIGH_WATER   (BUFFER_SIZE / 2U)
+
+/** @brief Max number of readers that can be registered on one buffer. */
+#define CB_MAX_READERS  4U
+
+/**
+* @brief Behaviour of cb_write() when the buffer is full.
+*/
+typedef enum {
+    CB_OVERWRITE_OLDEST,        /**< Producer never fails, the oldest unread entry is lost */
+    CB_DROP_NEWEST              /**< Producer rejects the new entry and the buffer is left intact */
+} cb_policy_t;
+
+/**
+* @brief One consumer of the buffer, with its own read position.
+*
+* Every registered reader sees every published entry in order. Only the
+* owning thread stores tail; the producer never waits for it.
+*/
+typedef struct {
+    atomic_t tail;                                  /**< read counter, stored by this reader only */
+    atomic_t overruns;                              /**< entries this reader lost because it was lapped */
+    struct k_sem *wake;                             /**< given by cb_notify_readers() (optional) */
+    const char *name;                               /**< short name for reports */
+} cb_reader_t;
 
 /**
 * @brief Circular buffer for storing sensor readings by value.
 *
+* Broadcast ring: safe for exactly one producer thread and up to
+* @ref CB_MAX_READERS reader threads without any lock. Entries are stored
+* once and every reader walks them with its own tail, so a second
+* consumer costs a cursor rather than a copy. head, claim and the tails
+* are free-running counters - only the producer stores head and claim,
+* only a reader stores its own tail. The slot index is the counter masked
+* with @ref BUFFER_MASK.
+*
 * - entries: array of sensor_reading structs (owned by the buffer)
-* - head:    index for writing new sensor data (producer position)
-* - tail:    index for reading sensor data (consumer position)
+* - head:    number of entries ever published (producer position)
+* - claim:   head plus the slots the producer is currently filling
+* - reader:  registered readers [0, readers), one tail each
 */
 typedef struct CircularBuffer{
     struct sensor_reading entries[BUFFER_SIZE];     /**< Array of sensor readings stored by value */ 
-    uint32_t head;                                  /**< write index */ 
-    uint32_t tail;                                  /**< read index */ 
+    atomic_t head;                                  /**< publish counter, stored by the producer only */ 
+    atomic_t claim;                                 /**< fill counter, stored by the producer only */
+    cb_reader_t reader[CB_MAX_READERS];             /**< registered readers */
+    atomic_t readers;                               /**< number of registered readers */
+    atomic_t dropped;                               /**< entries rejected when full (CB_DROP_NEWEST) */
+    cb_policy_t policy;                             /**< full-buffer behaviour, fixed at init */
 } CircularBuffer;
 
 /** @brief Global circular buffer instance for sensor data exchange between threads */
 extern CircularBuffer circular_buffer;  
 
+/** @brief Readers of circular_buffer, registered by main() before the threads start */
+extern cb_reader_t *detect_reader;          /**< anomaly_detect (Thread 3) */
+extern cb_reader_t *store_reader;           /**< store_write (Thread 6), CONFIG_PM_STORE only */
+
 /** Function prototypes */
-void circular_buffer_init(CircularBuffer *cb);
-void cb_write(CircularBuffer *cb, const struct sensor_reading* reading);
-bool cb_read(CircularBuffer *cb, struct sensor_reading* output);
+void circular_buffer_init(CircularBuffer *cb, cb_policy_t policy);
+cb_reader_t* cb_reader_register(CircularBuffer *cb, const char *name, struct k_sem *wake);
+bool cb_write(CircularBuffer *cb, const struct sensor_reading* reading);
+bool cb_read(CircularBuffer *cb, cb_reader_t *reader, struct sensor_reading* output);
+void cb_notify_readers(CircularBuffer *cb, uint32_t min_lag);
+uint32_t cb_lag(const CircularBuffer *cb, const cb_reader_t *reader);
+uint32_t cb_max_lag(const CircularBuffer *cb);
+uint32_t cb_overruns(const cb_reader_t *reader);
+uint32_t cb_dropped(const CircularBuffer *cb);
+
+/** Zero-copy producer API: fill the reserved slot in place, then commit it */
+struct sensor_reading* cb_write_reserve(CircularBuffer *cb);
+void cb_write_commit(CircularBuffer *cb);
+
+/** Zero-copy reader API: process a contiguous span where it sits, then release it */
+uint32_t cb_read_peek(CircularBuffer *cb, cb_reader_t *reader, const struct sensor_reading **span);
+bool cb_read_release(CircularBuffer *cb, cb_reader_t *reader, uint32_t count);
+
+/** Bulk variants - one publish / one release per call */
+uint32_t cb_write_n(CircularBuffer *cb, const struct sensor_reading *readings, uint32_t count);
+uint32_t cb_read_n(CircularBuffer *cb, cb_reader_t *reader, struct sensor_reading *output, uint32_t max_count);
 
-#endif  // CIRCULAR_BUFFER_H
\ No newline at end of file
+#endif  // CIRCULAR_BUFFER_H
@@ -0,0 +1,38 @@
+#ifndef DETECTION_H
+#define DETECTION_H
+
+/**
+* @file detection.h
+* @brief Batched anomaly detection kernels.
+*/
+
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+/** @brief Number of 32-bit mask words needed to hold one bit per channel. */
+#define DETECT_MASK_WORDS(count)    (((count) + 31U) / 32U)
+
+/**
+* @brief Instruction set the range-check kernel was compiled for.
+*/
+typedef enum {
+    DETECT_IMPL_SCALAR,         /**< Portable C loop */
+    DETECT_IMPL_SSE2,           /**< x86 4-lane (native_sim on x86 hosts) */
+    DETECT_IMPL_AVX,            /**< x86 8-lane */
+    DETECT_IMPL_NEON,           /**< AArch64 Advanced SIMD 4-lane */
+    DETECT_IMPL_HELIUM,         /**< Armv8.1-M MVE (Cortex-M55/M85) 4-lane */
+    DETECT_IMPL_Q16             /**< Integer compare on Q16.16 values (CONFIG_PM_FIXED_POINT) */
+} detect_impl_t;
+
+/** Function prototypes */
+uint32_t detect_out_of_range(const pm_value_t *values, const pm_value_t *min, const pm_value_t *max,
+                             uint32_t count, uint32_t *mask);
+uint32_t detect_out_of_range_scalar(const float *values, const float *min, const float *max,
+                                    uint32_t count, uint32_t *mask);
+uint32_t detect_out_of_range_q16(const q16_t *values, const q16_t *min, const q16_t *max,
+                                 uint32_t count, uint32_t *mask);
+detect_impl_t detect_impl(void);
+const char* detect_impl_name(void);
+
+#endif  // DETECTION_H
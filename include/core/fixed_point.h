@@ -0,0 +1,160 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+/**
+* @file fixed_point.h
+* @brief Q16.16 / Q15 fixed-point helpers and the pm_value_t sample type.
+*
+* With CONFIG_PM_FIXED_POINT, sensor values, operating ranges and every
+* statistic derived from them are Q16.16 integers (range +-32768,
+* resolution 1/65536), so parts without an FPU (Cortex-M0+/M3) run the
+* data path without soft-float. Smoothing factors are Q15. Conversion to
+* float happens only at the edges: the system logger and the C wrapper.
+*
+* Without it pm_value_t is a plain float and the helpers compile away.
+*/
+
+#include <stdint.h>
+
+/** @brief Fractional bits of a Q16.16 value */
+#define Q16_FRAC_BITS       16
+
+/** @brief 1.0 in Q16.16 */
+#define Q16_ONE             ((int32_t)1 << Q16_FRAC_BITS)
+
+/** @brief Q16.16 constant from a float literal - rounded, usable in constant expressions */
+#define Q16_CONST(f)        ((q16_t)((f) * 65536.0f + (((f) >= 0.0f) ? 0.5f : -0.5f)))
+
+/** @brief Q15 constant from a float literal in [0, 1) */
+#define Q15_CONST(f)        ((q15_t)((f) * 32768.0f + 0.5f))
+
+typedef int32_t q16_t;      /**< Signed Q16.16 */
+typedef int16_t q15_t;      /**< Signed Q15 (coefficients in [-1, 1)) */
+
+/**
+* @brief Clamp a 64-bit intermediate into the Q16.16 range.
+*/
+static inline q16_t q16_sat(int64_t v)
+{
+    if (v > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (v < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (q16_t)v;
+}
+
+/**
+* @brief Nearest Q16.16 value of a float, saturated to the representable range.
+*/
+static inline q16_t q16_from_float(float f)
+{
+    float scaled = f * 65536.0f;
+
+    if (scaled >= 2147483647.0f) {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return (q16_t)(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+}
+
+static inline float q16_to_float(q16_t q)
+{
+    return (float)q * (1.0f / 65536.0f);
+}
+
+/**
+* @brief Q16.16 quotient num / den, rounded to nearest and saturated.
+*
+* @param num Dividend in Q16.16, widened so sums can be divided directly.
+* @param den Divisor (plain integer, e.g. a sample count), must not be 0.
+*/
+static inline q16_t q16_div_int(int64_t num, uint32_t den)
+{
+    int64_t half = (int64_t)(den / 2U);
+    return q16_sat((num >= 0) ? ((num + half) / (int64_t)den) : ((num - half) / (int64_t)den));
+}
+
+/**
+* @brief Q16.16 quotient a / b, rounded towards zero and saturated.
+*/
+static inline q16_t q16_div(int64_t a, q16_t b)
+{
+    if (b == 0) {
+        return (a >= 0) ? INT32_MAX : INT32_MIN;
+    }
+    return q16_sat((a * Q16_ONE) / b);
+}
+
+/**
+* @brief Square of a Q16.16 value, in Q16.16 held in 64 bits.
+*/
+static inline int64_t q16_square(q16_t a)
+{
+    return ((int64_t)a * a) >> Q16_FRAC_BITS;
+}
+
+/**
+* @brief Square root of a non-negative Q16.16 value held in 64 bits.
+*
+* Bit-by-bit integer square root of a << 16, so the result is Q16.16
+* again (floor of the exact root). Negative input yields 0.
+*/
+static inline q16_t q16_sqrt(int64_t a)
+{
+    if (a <= 0) {
+        return 0;
+    }
+
+    uint64_t x   = (uint64_t)a << Q16_FRAC_BITS;
+    uint64_t res = 0U;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0U) {
+        if (x >= res + bit) {
+            x  -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return q16_sat((int64_t)res);
+}
+
+#ifdef CONFIG_PM_FIXED_POINT
+
+/** @brief Sensor value, range bound or derived statistic - Q16.16 */
+typedef q16_t   pm_value_t;
+
+/** @brief Running sum of pm_value_t samples (or their squares) - exact in 64 bits */
+typedef int64_t pm_sum_t;
+
+#define PM_VALUE(f)         Q16_CONST(f)
+
+static inline pm_value_t pm_value_from_float(float f) { return q16_from_float(f); }
+static inline float      pm_value_to_float(pm_value_t v) { return q16_to_float(v); }
+static inline pm_value_t pm_value_from_q16(q16_t q) { return q; }
+static inline q16_t      pm_value_to_q16(pm_value_t v) { return v; }
+
+#else
+
+typedef float   pm_value_t;
+typedef float   pm_sum_t;
+
+#define PM_VALUE(f)         (f)
+
+static inline pm_value_t pm_value_from_float(float f) { return f; }
+static inline float      pm_value_to_float(pm_value_t v) { return v; }
+static inline pm_value_t pm_value_from_q16(q16_t q) { return q16_to_float(q); }
+static inline q16_t      pm_value_to_q16(pm_value_t v) { return q16_from_float(v); }
+
+#endif  // CONFIG_PM_FIXED_POINT
+
+#endif  // FIXED_POINT_H
@@ -0,0 +1,101 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+/**
+* @file history.h
+* @brief Compressed in-RAM sample history of one sensor.
+*
+* Samples are encoded Gorilla-style into fixed-size blocks: timestamps as
+* delta-of-deltas (1 bit for a steady sampling period), values as the XOR
+* with the previous value (1 bit for an unchanged value, otherwise only
+* the meaningful bits). Each block starts with an uncompressed sample, so
+* blocks decode independently. The blocks form a ring - when it is full
+* the oldest block is recycled.
+*
+* One thread appends. Other threads may iterate concurrently: every block
+* carries the serial number it was opened with, and a reader discards
+* what it decoded if the serial changed underneath it (like a seqlock).
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/atomic.h>
+
+#include "fixed_point.h"
+
+/** @brief Encoded bytes per block (Kconfig: CONFIG_PM_HISTORY_BLOCK_SIZE) */
+#define HISTORY_BLOCK_BYTES     ((uint32_t)CONFIG_PM_HISTORY_BLOCK_SIZE)
+
+/** @brief Blocks per sensor (Kconfig: CONFIG_PM_HISTORY_BLOCKS) */
+#define HISTORY_BLOCKS          ((uint32_t)CONFIG_PM_HISTORY_BLOCKS)
+
+/**
+* @brief One compressed block.
+*/
+typedef struct {
+    atomic_t serial;                    /**< Serial number the block was opened with */
+    uint32_t t_first_ms;                /**< Timestamp of the first sample (stored raw) */
+    uint32_t t_last_ms;                 /**< Timestamp of the last sample */
+    uint32_t v_first;                   /**< Bit pattern of the first value (stored raw) */
+    uint16_t count;                     /**< Samples in the block */
+    uint16_t bits;                      /**< Encoded bits used in data[] */
+    uint8_t  data[HISTORY_BLOCK_BYTES]; /**< Samples 2..count, MSB first */
+} history_block_t;
+
+/**
+* @brief History of one sensor.
+*
+* Statically sized, no allocation. Block serial s lives in
+* block[s % HISTORY_BLOCKS]; serials [first, next) are live.
+*/
+typedef struct {
+    history_block_t block[HISTORY_BLOCKS];
+    atomic_t first;                     /**< Serial of the oldest live block */
+    atomic_t next;                      /**< Serial of the next block to open */
+
+    // Encoder state of the newest block
+    uint32_t prev_t;                    /**< Previous timestamp */
+    int32_t  prev_delta;                /**< Previous timestamp delta */
+    uint32_t prev_v;                    /**< Previous value bits */
+    uint8_t  leading;                   /**< Leading zeros of the current XOR window (0xFF: none yet) */
+    uint8_t  trailing;                  /**< Trailing zeros of the current XOR window */
+} history_t;
+
+/**
+* @brief Lazy decoder over a time range of one history.
+*
+* Decodes one sample per history_iter_next() call; blocks entirely
+* before the range are skipped without decoding.
+*/
+typedef struct {
+    const history_t *h;
+    uint32_t from_ms;                   /**< Range start (inclusive) */
+    uint32_t to_ms;                     /**< Range end (inclusive) */
+    uint32_t serial;                    /**< Block being decoded */
+    bool     loaded;                    /**< Decoder state below belongs to serial */
+    uint16_t index;                     /**< Next sample within the block */
+    uint16_t count;                     /**< Samples of the block known to the decoder */
+    uint16_t pos;                       /**< Bit position in data[] */
+    uint32_t t;                         /**< Last decoded timestamp */
+    int32_t  delta;                     /**< Last decoded timestamp delta */
+    uint32_t v;                         /**< Last decoded value bits */
+    uint8_t  leading;
+    uint8_t  trailing;
+} history_iter_t;
+
+/**
+* @brief Memory use of one history.
+*/
+typedef struct {
+    uint32_t samples;                   /**< Samples held */
+    uint32_t bytes;                     /**< Bytes holding them (block headers + encoded bits) */
+} history_usage_t;
+
+/** Function prototypes */
+void history_init(history_t *h);
+void history_append(history_t *h, uint32_t timestamp_ms, pm_value_t value);
+void history_iter_init(history_iter_t *it, const history_t *h, uint32_t from_ms, uint32_t to_ms);
+bool history_iter_next(history_iter_t *it, uint32_t *timestamp_ms, pm_value_t *value);
+void history_usage(const history_t *h, history_usage_t *out);
+
+#endif  // HISTORY_H
@@ -0,0 +1,64 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+/**
+* @file instrument.h
+* @brief Optional per-stage latency histograms and per-thread CPU accounting.
+*
+* Enabled with CONFIG_PM_INSTRUMENTATION. Stages are timed with the cycle
+* counter and recorded into lock-free latency histograms (latency.h), so
+* any thread can record without locks. When the option is off, the INSTR_*
+* macros expand to nothing and their arguments are never evaluated - the
+* data path is unchanged. Sample-to-alert latency is tracked always, not
+* here (see alert_latency in shared_resources.h).
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#include "latency.h"
+
+/** @brief Max number of threads tracked for CPU accounting */
+#define INSTR_MAX_THREADS   8U
+
+/**
+* @brief Timed pipeline stages.
+*/
+typedef enum {
+    INSTR_STAGE_WRITE,          /**< Thread 1: sampling the sensors due on one tick */
+    INSTR_STAGE_COLLECT,        /**< Thread 2: one pass over the updated sensors */
+    INSTR_STAGE_ENQUEUE,        /**< Thread 2: one reading into the circular buffer */
+    INSTR_STAGE_DETECT,         /**< Thread 3: one buffer span through detection */
+    INSTR_STAGE_HANDLE,         /**< Thread 4: one anomaly event */
+    INSTR_STAGE_COUNT
+} instr_stage_t;
+
+#ifdef CONFIG_PM_INSTRUMENTATION
+
+/** Function prototypes */
+void instr_record(instr_stage_t stage, uint32_t us);
+bool instr_summary(instr_stage_t stage, latency_summary_t *out);
+const char* instr_stage_name(instr_stage_t stage);
+bool instr_register_thread(struct k_thread *thread, const char *name);
+const char* instr_thread_name(uint32_t index);
+void instr_dump(void);
+
+/** @brief Start timing - declares the cycle stamp t */
+#define INSTR_BEGIN(t)              uint32_t t = k_cycle_get_32()
+
+/** @brief Stop timing started with INSTR_BEGIN(t) and record it under stage */
+#define INSTR_END(stage, t)         instr_record((stage), k_cyc_to_us_floor32(k_cycle_get_32() - (t)))
+
+/** @brief Track a thread's CPU utilization */
+#define INSTR_THREAD(thread, name)  (void)instr_register_thread((thread), (name))
+
+#else
+
+#define INSTR_BEGIN(t)              do { } while (0)
+#define INSTR_END(stage, t)         do { } while (0)
+#define INSTR_THREAD(thread, name)  do { } while (0)
+
+#endif  // CONFIG_PM_INSTRUMENTATION
+
+#endif  // INSTRUMENT_H
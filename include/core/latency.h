@@ -0,0 +1,43 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/**
+* @file latency.h
+* @brief Lock-free fixed-bucket latency histograms.
+*
+* Bucket 0 holds 0 us, bucket b holds [2^(b-1), 2^b) us, and the last
+* bucket also holds everything above. Recording is an atomic increment
+* (plus a compare-and-swap for a new maximum), so any thread can record
+* into a shared histogram without a lock.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/atomic.h>
+
+/** @brief Number of log2 buckets - the last one starts at about 4.2 s */
+#define LATENCY_BUCKETS     24U
+
+/**
+* @brief One histogram. Zero-initialized storage is an empty histogram.
+*/
+typedef struct {
+    atomic_t bucket[LATENCY_BUCKETS];   /**< Samples per log2 bucket */
+    atomic_t max_us;                    /**< Largest sample */
+} latency_hist_t;
+
+/**
+* @brief Snapshot of one histogram.
+*/
+typedef struct {
+    uint32_t count;             /**< Samples recorded */
+    uint32_t p50_us;            /**< Median (upper edge of its bucket) */
+    uint32_t p99_us;            /**< 99th percentile (upper edge of its bucket) */
+    uint32_t max_us;            /**< Largest sample */
+} latency_summary_t;
+
+/** Function prototypes */
+void latency_record(latency_hist_t *h, uint32_t us);
+bool latency_summary(const latency_hist_t *h, latency_summary_t *out);
+
+#endif  // LATENCY_H
@@ -0,0 +1,89 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+/**
+* @file rollup.h
+* @brief Per-sensor tumbling-window rollups at 1 s, 1 min and 1 h.
+*
+* Each level keeps one running aggregate (count, min, max, sum, last) of
+* the window in progress - no raw samples are buffered. Windows are
+* aligned to multiples of their length, so every 1 s window nests in one
+* 1 min window and every 1 min window in one 1 h window. Raw samples feed
+* only the 1 s level; a closed 1 s window is merged into the 1 min level,
+* and a closed 1 min window into the 1 h level, so each level costs O(1)
+* per window below it and the float sums never span more than 60 terms
+* above the 1 s level (the 64-bit sums of CONFIG_PM_FIXED_POINT are exact).
+*
+* A window closes when a sample (rollup_push) or a clock tick
+* (rollup_expire) arrives beyond its end. A sample that arrives after its
+* 1 s window was closed is dropped and counted rather than reopening the
+* window, so no interval is ever emitted twice.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fixed_point.h"
+
+/**
+* @brief Rollup levels, shortest first.
+*/
+typedef enum {
+    ROLLUP_1S,
+    ROLLUP_1M,
+    ROLLUP_1H,
+    ROLLUP_LEVELS
+} rollup_level_t;
+
+/**
+* @brief Capacity of the out[] array of rollup_push()/rollup_expire().
+*
+* Normally at most one window per level closes per call; the bound also
+* covers timestamps that jump backwards, where each closing level can
+* cascade into every level above it.
+*/
+#define ROLLUP_MAX_CLOSED   ((uint32_t)ROLLUP_LEVELS * ((uint32_t)ROLLUP_LEVELS + 1U) / 2U)
+
+/**
+* @brief Running aggregate of one window in progress.
+*/
+typedef struct {
+    uint32_t start_ms;          /**< Window start (multiple of the window length) */
+    uint32_t count;             /**< Samples so far, 0 if the window is empty */
+    pm_value_t min;
+    pm_value_t max;
+    pm_sum_t sum;
+    pm_value_t last;            /**< Most recent sample */
+} rollup_acc_t;
+
+/**
+* @brief Rollups of one sensor.
+*/
+typedef struct {
+    rollup_acc_t level[ROLLUP_LEVELS];
+    uint32_t closed_ms;         /**< End of the newest closed 1 s window - earlier samples are late (0: none closed) */
+    uint32_t late;              /**< Samples dropped because their window was already closed */
+} sensor_rollup_t;
+
+/**
+* @brief Summary of one closed window.
+*/
+typedef struct {
+    uint32_t start_ms;          /**< Window start */
+    uint32_t count;             /**< Samples in the window */
+    pm_value_t min;
+    pm_value_t max;
+    pm_value_t mean;
+    pm_value_t last;            /**< Last sample of the window */
+    uint8_t  level;             /**< rollup_level_t */
+} rollup_record_t;
+
+/** Function prototypes */
+void rollup_init(sensor_rollup_t *r);
+uint32_t rollup_push(sensor_rollup_t *r, uint32_t timestamp_ms, pm_value_t value,
+                     rollup_record_t out[ROLLUP_MAX_CLOSED]);
+uint32_t rollup_expire(sensor_rollup_t *r, uint32_t now_ms, rollup_record_t out[ROLLUP_MAX_CLOSED]);
+uint32_t rollup_window_ms(rollup_level_t level);
+const char* rollup_level_name(rollup_level_t level);
+
+#endif  // ROLLUP_H
@@ -0,0 +1,64 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/**
+* @file scheduler.h
+* @brief Hierarchical timer wheel driving per-sensor sampling deadlines.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Scheduler resolution - shortest supported sample period. */
+#define SCHED_TICK_MS       1U
+
+/** @brief log2 of the buckets per wheel level. */
+#define SCHED_WHEEL_BITS    6U
+
+/** @brief Buckets per wheel level - one revolution of level 0 spans this many ticks. */
+#define SCHED_WHEEL_SLOTS   (1U << SCHED_WHEEL_BITS)
+
+/** @brief Wheel levels - together they span SCHED_WHEEL_SLOTS^levels ticks (262 s at 1 ms). */
+#define SCHED_WHEEL_LEVELS  3U
+
+/** @brief Max number of scheduled entries (entry IDs are 0 .. SCHED_MAX_ENTRIES - 1). */
+#define SCHED_MAX_ENTRIES   ((uint32_t)CONFIG_PM_SCHED_MAX_ENTRIES)
+
+/** @brief End-of-list marker for bucket chains. */
+#define SCHED_NONE          0xFFFFU
+
+/**
+* @brief One periodic job - an intrusive node of its bucket's list.
+*/
+typedef struct {
+    uint32_t deadline;          /**< Absolute tick of the next run */
+    uint32_t period;            /**< Ticks between runs */
+    uint16_t next;              /**< Next entry in the same bucket, or SCHED_NONE */
+    bool     active;            /**< Entry is scheduled */
+} sched_entry_t;
+
+/**
+* @brief Hierarchical timer wheel.
+*
+* Level 0 holds the entries due within one revolution, in the bucket of
+* their deadline tick; each higher level holds entries further away in
+* buckets SCHED_WHEEL_SLOTS times coarser. When level 0 completes a
+* revolution, the next bucket of level 1 is redistributed into the
+* finer levels (and likewise up the hierarchy). Every entry in the
+* current level-0 bucket is therefore due: a tick visits only the due
+* entries plus, amortized, a bounded number of moves per reschedule,
+* independent of the number of scheduled entries.
+*/
+typedef struct {
+    uint16_t      bucket[SCHED_WHEEL_LEVELS][SCHED_WHEEL_SLOTS]; /**< Head entry of each bucket */
+    sched_entry_t entry[SCHED_MAX_ENTRIES];                      /**< Entries indexed by ID */
+    uint32_t      now;                                           /**< Last processed tick */
+} sched_wheel_t;
+
+/** Function prototypes */
+void sched_init(sched_wheel_t *w, uint32_t now);
+bool sched_add(sched_wheel_t *w, uint16_t id, uint32_t period, uint32_t first_deadline);
+uint32_t sched_tick(sched_wheel_t *w, uint16_t *due, uint32_t max_due);
+uint32_t sched_next_deadline(const sched_wheel_t *w);
+
+#endif  // SCHEDULER_H
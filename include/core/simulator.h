@@ -0,0 +1,96 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+/**
+* @file simulator.h
+* @brief Synthetic sensor signals with physical models and fault injection.
+*
+* Every channel owns its own xorshift32 generator and model state, so
+* channels are independent and reproducible from their seed, and no
+* shared state (rand()) is touched. The models run in Q16.16 integer
+* arithmetic in every build - no float, no division per sample - and
+* the result is converted to pm_value_t on the way out.
+*
+* Models, all derived from the channel's operating range so that a
+* healthy channel stays inside it:
+*  - thermal:   first-order lag towards a slowly drifting setpoint
+*  - pressure:  pump-cycle oscillation around the operating point
+*  - vibration: running speed, its 2nd harmonic and a bearing-band tone
+* each with approximately Gaussian measurement noise.
+*
+* A channel can carry one scripted fault on top of its model: a ramp
+* (gradual degradation), a spike (short burst offset) or a stuck sensor
+* (frozen output).
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fixed_point.h"
+
+/** @brief Pump cycle frequency of the pressure model */
+#define SIM_PUMP_HZ             Q16_CONST(0.5f)
+
+/** @brief Running speed of the simulated drive in Hz (1485 rpm 4-pole motor) - also the spectrum stage's 1x order */
+#define SIM_DRIVE_SPEED_HZ      24.75f
+
+/** @brief Running speed of the vibration model */
+#define SIM_RUNNING_SPEED_HZ    Q16_CONST(SIM_DRIVE_SPEED_HZ)
+
+/** @brief Bearing defect tone of the vibration model - inside the spectrum stage's bearing band */
+#define SIM_BEARING_HZ          Q16_CONST(181.5f)
+
+/**
+* @brief Signal model of a channel.
+*/
+typedef enum {
+    SIM_MODEL_THERMAL,
+    SIM_MODEL_PRESSURE,
+    SIM_MODEL_VIBRATION
+} sim_model_t;
+
+/**
+* @brief Kind of an injected fault.
+*/
+typedef enum {
+    SIM_FAULT_NONE,
+    SIM_FAULT_RAMP,             /**< Offset growing linearly to magnitude over the duration, then held */
+    SIM_FAULT_SPIKE,            /**< Offset of magnitude for the duration */
+    SIM_FAULT_STUCK             /**< Output frozen at its last healthy value for the duration */
+} sim_fault_kind_t;
+
+/**
+* @brief One scripted fault.
+*/
+typedef struct {
+    uint32_t start_ms;          /**< Onset (same clock as the sample timestamps) */
+    uint32_t duration_ms;       /**< Length; 0 = permanent (a ramp then becomes a step) */
+    q16_t    magnitude;         /**< Offset in sensor units (unused for SIM_FAULT_STUCK) */
+    uint8_t  kind;              /**< sim_fault_kind_t */
+} sim_fault_t;
+
+/**
+* @brief State of one simulated channel.
+*/
+typedef struct {
+    uint32_t    rng;            /**< xorshift32 state, never 0 */
+    uint8_t     model;          /**< sim_model_t */
+    q16_t       base;           /**< Operating point (middle of the range) */
+    q16_t       amplitude;      /**< Swing of the model around the operating point */
+    q16_t       noise;          /**< Standard deviation of the measurement noise */
+    q16_t       level;          /**< Thermal: current temperature */
+    q16_t       drift;          /**< Thermal: setpoint offset, a bounded random walk */
+    uint32_t    phase_step;     /**< Phase advance of the fundamental per ms (2^32 = one cycle) */
+    q16_t       last;           /**< Last model output, without any fault offset - held by a stuck fault */
+    sim_fault_t fault;
+} sim_channel_t;
+
+/** Function prototypes */
+void sim_init(sim_channel_t *ch, sim_model_t model, pm_value_t min, pm_value_t max, uint32_t seed);
+void sim_inject(sim_channel_t *ch, const sim_fault_t *fault);
+void sim_clear_fault(sim_channel_t *ch);
+bool sim_fault_active(const sim_channel_t *ch, uint32_t t_ms);
+pm_value_t sim_sample(sim_channel_t *ch, uint32_t t_ms);
+void sim_fill(sim_channel_t *ch, uint32_t t_ms, uint32_t period_ms, pm_value_t *out, uint32_t count);
+
+#endif  // SIMULATOR_H
@@ -0,0 +1,69 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+/**
+* @file spectrum.h
+* @brief Fixed-size real FFT and vibration band-energy features.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Samples per analysis frame (power of two). */
+#define SPECTRUM_FFT_SIZE           1024U
+
+/** @brief Number of one-sided spectrum bins (DC .. Nyquist - 1). */
+#define SPECTRUM_BINS               (SPECTRUM_FFT_SIZE / 2U)
+
+/** @brief Number of vibration channels that get a frame accumulator. */
+#define SPECTRUM_CHANNELS           1U
+
+/** @brief Relative half-width of the 1x / 2x running-speed bands. */
+#define SPECTRUM_ORDER_TOLERANCE    0.1f
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* @brief Machine-specific parameters of the spectral analysis.
+*/
+typedef struct {
+    float sample_rate_hz;       /**< Vibration sampling rate */
+    float running_speed_hz;     /**< Shaft speed (1x order) */
+    float bearing_lo_hz;        /**< Lower edge of the bearing defect band */
+    float bearing_hi_hz;        /**< Upper edge of the bearing defect band */
+} spectrum_config_t;
+
+/**
+* @brief Band-energy features of one frame.
+*
+* Energies are sums of windowed power-spectrum bins.
+*/
+typedef struct {
+    float total_energy;         /**< All bins except DC */
+    float band_1x;              /**< Around 1x running speed - imbalance */
+    float band_2x;              /**< Around 2x running speed - misalignment / looseness */
+    float band_bearing;         /**< Bearing defect band */
+    float peak_hz;              /**< Frequency of the strongest non-DC bin */
+} spectrum_features_t;
+
+/**
+* @brief Accumulates samples of one channel into analysis frames.
+*/
+typedef struct {
+    float    samples[SPECTRUM_FFT_SIZE];    /**< Frame being filled */
+    uint16_t fill;                          /**< Samples in the frame so far */
+} spectrum_frame_t;
+
+/** Function prototypes */
+bool spectrum_analyze(const float *frame, const spectrum_config_t *cfg, spectrum_features_t *out);
+void spectrum_frame_init(spectrum_frame_t *frame);
+bool spectrum_frame_push(spectrum_frame_t *frame, float value, const spectrum_config_t *cfg,
+                        spectrum_features_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPECTRUM_H
@@ -0,0 +1,63 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+/**
+* @file statistics.h
+* @brief Streaming per-sensor statistics with constant state and O(1) updates.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fixed_point.h"
+
+/** @brief Default EWMA smoothing factor (weight of the newest sample). */
+#define STATS_EWMA_ALPHA        0.1f
+
+/** @brief |z| above which a sample is reported as a statistical anomaly. */
+#define STATS_Z_THRESHOLD       PM_VALUE(3.0f)
+
+/** @brief Samples required before the z-score test is trusted. */
+#define STATS_WARMUP_SAMPLES    8U
+
+/**
+* @brief Running statistics of one sensor.
+*
+* Fixed size regardless of how many samples have been seen - no history
+* is kept or rescanned. In float builds the Welford accumulators carry
+* Kahan compensation terms: a plain float M2 stops absorbing updates once
+* it is about 2^24 times the per-sample increment, which a 1 kHz channel
+* reaches within hours, and double would be emulated in software on the
+* single-precision FPU. With CONFIG_PM_FIXED_POINT every field is an
+* integer: values in Q16.16, the mean in Q32.32 (so the rounding of each
+* step does not accumulate over long runs), M2 in Q16.16 widened to 64
+* bits, alpha in Q15.
+*/
+typedef struct {
+    uint32_t   count;           /**< Number of samples accumulated */
+#ifdef CONFIG_PM_FIXED_POINT
+    int64_t    mean;            /**< Welford running mean */
+    int64_t    m2;              /**< Welford sum of squared deviations from the mean */
+    q15_t      alpha;           /**< EWMA smoothing factor in (0, 1) */
+#else
+    float      mean;            /**< Welford running mean */
+    float      mean_c;          /**< Rounding error carried over from the last mean update */
+    float      m2;              /**< Welford sum of squared deviations from the mean */
+    float      m2_c;            /**< Rounding error carried over from the last M2 update */
+    float      alpha;           /**< EWMA smoothing factor in (0, 1] */
+#endif
+    pm_value_t ewma;            /**< Exponentially weighted moving average */
+    pm_value_t min;             /**< Smallest sample seen */
+    pm_value_t max;             /**< Largest sample seen */
+} sensor_stats_t;
+
+/** Function prototypes */
+void stats_init(sensor_stats_t *st, float alpha);
+pm_value_t stats_update(sensor_stats_t *st, pm_value_t value);
+pm_value_t stats_mean(const sensor_stats_t *st);
+pm_value_t stats_variance(const sensor_stats_t *st);
+pm_value_t stats_stddev(const sensor_stats_t *st);
+pm_value_t stats_zscore(const sensor_stats_t *st, pm_value_t value);
+bool stats_is_outlier(const sensor_stats_t *st, pm_value_t z, pm_value_t threshold);
+
+#endif  // STATISTICS_H
@@ -0,0 +1,108 @@
+#ifndef STORE_H
+#define STORE_H
+
+/**
+* @file store.h
+* @brief Persistent append-only reading history on a flash partition.
+*
+* Readings are packed into page-sized batches in RAM and written to flash
+* one whole page at a time, so every byte is programmed exactly once and
+* nothing is ever rewritten in place. The partition is split into
+* equal segments used as a circular log: when the head reaches the end of
+* a segment, the next (oldest) segment is erased and reused, so every
+* segment wears at the same rate.
+*
+* Each flash page holds a header (sequence number, time span, record
+* count) and a run of fixed-size records, protected by one CRC-32. A torn
+* or corrupt page fails its CRC and is skipped by the reader.
+*
+* Producer and flash writer are decoupled by a small ring of page
+* buffers: store_append() only copies a record into RAM, and
+* store_service() does the CRC, flash programming and erases. They run in
+* two threads - the ring is filled by one that drains its own circular
+* buffer reader, and written by a lower-priority one - so readings keep
+* flowing into the page buffers while a page program or a segment erase
+* is in progress.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "shared_resources.h"
+
+/** @brief Bytes per flash page - the unit of one flash write (Kconfig: CONFIG_PM_STORE_PAGE_SIZE) */
+#define STORE_PAGE_SIZE         ((uint32_t)CONFIG_PM_STORE_PAGE_SIZE)
+
+/** @brief Bytes per segment - the unit of one erase (Kconfig: CONFIG_PM_STORE_SEGMENT_SIZE) */
+#define STORE_SEGMENT_SIZE      ((uint32_t)CONFIG_PM_STORE_SEGMENT_SIZE)
+
+/** @brief Page buffers between producer and flash writer (Kconfig: CONFIG_PM_STORE_PAGE_BUFFERS) */
+#define STORE_PAGE_BUFFERS      ((uint32_t)CONFIG_PM_STORE_PAGE_BUFFERS)
+
+/** @brief Marks a valid page header - per value format, so a float log is never read as Q16.16 */
+#ifdef CONFIG_PM_FIXED_POINT
+#define STORE_PAGE_MAGIC        0x5451U
+#else
+#define STORE_PAGE_MAGIC        0x5453U
+#endif
+
+/**
+* @brief Header at the start of every flash page.
+*/
+typedef struct {
+    uint16_t magic;             /**< STORE_PAGE_MAGIC */
+    uint16_t count;             /**< Records in the page */
+    uint32_t page_seq;          /**< Monotonic page sequence number - orders the log */
+    uint32_t t_min_ms;          /**< Earliest record timestamp */
+    uint32_t t_max_ms;          /**< Latest record timestamp */
+    uint32_t crc;               /**< CRC-32 (IEEE) over the header up to here and all records */
+} store_page_header_t;
+
+/** @brief Records per page */
+#define STORE_PAGE_RECORDS      ((STORE_PAGE_SIZE - (uint32_t)sizeof(store_page_header_t)) / \
+                                 (uint32_t)sizeof(struct sensor_reading))
+
+/**
+* @brief One page as laid out in flash.
+*/
+typedef struct {
+    store_page_header_t   header;
+    struct sensor_reading record[STORE_PAGE_RECORDS];
+} store_page_t;
+
+/**
+* @brief Read position in the log.
+*
+* Owns a page buffer, so keep it off small thread stacks.
+*/
+typedef struct {
+    uint32_t     segment;       /**< Segment being read */
+    uint32_t     page;          /**< Page within the segment */
+    uint32_t     segments_left; /**< Segments still to visit, including this one */
+    uint16_t     index;         /**< Next record within the loaded page */
+    bool         loaded;        /**< page holds a verified copy of (segment, page) */
+    store_page_t buf;
+} store_cursor_t;
+
+/**
+* @brief Counters of the store.
+*/
+typedef struct {
+    uint32_t appended;          /**< Records accepted by store_append() */
+    uint32_t dropped;           /**< Records dropped because every page buffer was pending */
+    uint32_t pages_written;     /**< Pages programmed */
+    uint32_t segments_erased;   /**< Segments erased */
+    uint32_t write_errors;      /**< Failed flash writes or erases (page lost) */
+} store_stats_t;
+
+/** Function prototypes */
+int  store_init(void);
+bool store_append(const struct sensor_reading *reading);
+uint32_t store_service(void);
+uint32_t store_pending(void);
+void store_get_stats(store_stats_t *out);
+
+int  store_seek(store_cursor_t *cursor, uint32_t t_ms);
+int  store_next(store_cursor_t *cursor, struct sensor_reading *out);
+
+#endif  // STORE_H
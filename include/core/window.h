@@ -0,0 +1,52 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+/**
+* @file window.h
+* @brief Per-sensor sliding-window features over the last WINDOW_SIZE samples.
+*/
+
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+/** @brief Samples per window (power of two, at most 128). */
+#define WINDOW_SIZE     32U
+
+/** @brief Index mask for the sample ring and the min/max deques. */
+#define WINDOW_MASK     (WINDOW_SIZE - 1U)
+
+/**
+* @brief Sliding window of one sensor.
+*
+* Statically sized, no allocation. The sample ring holds the window itself;
+* two monotonic deques of sample positions give the window min and max,
+* and running sums give the mean and RMS.
+*
+* Sample positions are the free-running sample count truncated to 8 bits,
+* which stays unique while WINDOW_SIZE <= 128.
+*
+* With CONFIG_PM_FIXED_POINT the sums are 64-bit integers, which are
+* exact: what a sample added is subtracted again when it leaves.
+*/
+typedef struct {
+    pm_value_t samples[WINDOW_SIZE];    /**< Ring of the last WINDOW_SIZE samples */
+    uint8_t  min_dq[WINDOW_SIZE];       /**< Positions with increasing values (front = window min) */
+    uint8_t  max_dq[WINDOW_SIZE];       /**< Positions with decreasing values (front = window max) */
+    uint8_t  min_head, min_tail;        /**< Free-running min deque counters */
+    uint8_t  max_head, max_tail;        /**< Free-running max deque counters */
+    uint32_t count;                     /**< Total samples pushed */
+    pm_sum_t sum;                       /**< Sum of samples in the window */
+    pm_sum_t sum_sq;                    /**< Sum of squared samples in the window */
+} sensor_window_t;
+
+/** Function prototypes */
+void window_init(sensor_window_t *w);
+void window_push(sensor_window_t *w, pm_value_t value);
+uint32_t window_length(const sensor_window_t *w);
+pm_value_t window_mean(const sensor_window_t *w);
+pm_value_t window_min(const sensor_window_t *w);
+pm_value_t window_max(const sensor_window_t *w);
+pm_value_t window_rms(const sensor_window_t *w);
+
+#endif  // WINDOW_H
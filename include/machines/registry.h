@@ -0,0 +1,130 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+/**
+ * @file registry.h
+ * @brief Fleet registry - the machine pool and ID lookup.
+ *
+ * The registry is built from topology.h by the compiler and placed in ROM.
+ * Machines are densely packed in topology order, so iteration is a plain
+ * index loop, and are found by ID through an open-addressing hash map.
+ * Sensors are found by their fleet-unique number through a second map.
+*/
+
+#include <stdint.h>
+
+#include "wrapper.h"
+#include "sensor.h"
+
+/** @brief Machine pool capacity (Kconfig: CONFIG_PM_MAX_MACHINES) */
+#define MAX_MACHINES        ((uint32_t)CONFIG_PM_MAX_MACHINES)
+
+/** @brief Marks an unused machine index */
+#define MACHINE_INDEX_NONE  0xFFFFU
+
+static_assert(MAX_MACHINES < MACHINE_INDEX_NONE, "Machine pool exceeds the 16-bit index space");
+
+/**
+ * @brief Fixed-capacity open-addressing map from a 16-bit ID to a 16-bit index.
+ *
+ * The table is sized to a power of two at least twice the capacity, so the
+ * load factor never exceeds 50 % and probes stay short. Entries are never
+ * removed.
+*/
+template <uint32_t Capacity>
+class IdMap {
+private:
+    static constexpr uint32_t tableSize()
+    {
+        uint32_t size = 1U;
+        while (size < 2U * Capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static constexpr uint32_t SIZE = tableSize();
+    static constexpr uint32_t MASK = SIZE - 1U;
+    static constexpr uint16_t EMPTY = 0xFFFFU;
+
+    uint16_t keys[SIZE];
+    uint16_t values[SIZE];
+
+    // Fibonacci hashing spreads sequential IDs over the table
+    static constexpr uint32_t hash(uint16_t key) { return (static_cast<uint32_t>(key) * 2654435769U) >> 16; }
+
+public:
+    constexpr IdMap() : keys{}, values{}
+    {
+        for (uint32_t i = 0U; i < SIZE; i++) {
+            keys[i] = EMPTY;
+        }
+    }
+
+    // False if the key is already present (or is the reserved EMPTY key)
+    constexpr bool insert(uint16_t key, uint16_t value)
+    {
+        if (key == EMPTY) {
+            return false;
+        }
+        for (uint32_t i = hash(key) & MASK; ; i = (i + 1U) & MASK) {
+            if (keys[i] == key) {
+                return false;
+            }
+            if (keys[i] == EMPTY) {
+                keys[i]   = key;
+                values[i] = value;
+                return true;
+            }
+        }
+    }
+
+    // Value stored for key, or 0xFFFF if absent
+    constexpr uint16_t find(uint16_t key) const
+    {
+        if (key == EMPTY) {
+            return EMPTY;
+        }
+        for (uint32_t i = hash(key) & MASK; keys[i] != EMPTY; i = (i + 1U) & MASK) {
+            if (keys[i] == key) {
+                return values[i];
+            }
+        }
+        return EMPTY;
+    }
+};
+
+class Registry {
+private:
+    Machine machines[MAX_MACHINES];                 // Dense pool, topology order
+    uint16_t machineCount;
+    IdMap<MAX_MACHINES> machineIds;                 // Machine ID -> pool index
+    IdMap<MAX_FLEET_SENSORS> sensorNumbers;         // Sensor number -> sensor slot
+
+public:
+    constexpr Registry() : machines{}, machineCount(0U), machineIds(), sensorNumbers() {}
+
+    // Compile-time construction only (see registry.cpp)
+    constexpr void addMachine(uint16_t machineId, const char* name, MachineType type)
+    {
+        machines[machineCount] = Machine(machineCount, machineId, name, type);
+        (void)machineIds.insert(machineId, machineCount);
+        machineCount++;
+    }
+
+    constexpr void addSensor(uint16_t machineId, SensorType type, uint16_t sensorNumber, uint16_t slot)
+    {
+        machines[machineIds.find(machineId)].addSlot(slot, type);
+        (void)sensorNumbers.insert(sensorNumber, slot);
+    }
+
+    uint16_t getMachineCount() const { return machineCount; }
+    const Machine* machineAt(uint16_t index) const;
+    const Machine* findMachine(uint16_t machineId) const;
+    uint16_t findSensorSlot(uint16_t sensorNumber) const { return sensorNumbers.find(sensorNumber); }
+};
+
+/** @brief Global fleet registry (ROM) */
+extern const Registry registry;
+
+#endif // REGISTRY_H
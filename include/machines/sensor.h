@@ -8,32 +8,37 @@
 */
 
 #include <stdint.h>
+#include <zephyr/kernel.h>
 
 #include "wrapper.h"
+#include "sensor_bank.h"
 
-#define MAX_SENSORS         3U      // Max sensors per machine
-#define MAX_TEMP_SENSORS    3U      // Air Compressor + Steam Boiler + Electric Motor
-#define MAX_PRESS_SENSORS   2U      // Air Compressor + Steam Boiler
-#define MAX_VIB_SENSORS     1U      // Air Compressor only
+#define MAX_SENSORS         ((uint32_t)CONFIG_PM_MAX_SENSORS_PER_MACHINE)  // Max sensors per machine
 
-// Abstract base class for all sensor types
+/** @brief Marks an unused entry in Machine's type-to-index table */
+#define SENSOR_INDEX_NONE   0xFFU
+
+static_assert(MAX_FLEET_SENSORS < SENSOR_SLOT_NONE, "Sensor capacity exceeds the 16-bit slot space");
+static_assert(MAX_SENSORS < SENSOR_INDEX_NONE, "Too many sensors per machine for 8-bit indices");
+
+// Abstract base class for all sensor types - a facade over one sensor slot
 class Sensor {
 protected:
-    uint16_t sensorNumber;                                  // Unique ID for the sensor
-    float    sensorValue;                                   // Current sensor reading
-    float    minValue;
-    float    maxValue;
+    uint16_t slot;                                          // Index of this sensor's state in sensor_bank
 
 public:
-    explicit Sensor(uint16_t number, float min, float max) 
-        : sensorNumber(number), sensorValue(0.0f), minValue(min), maxValue(max) {}              // Constructor
+    explicit Sensor(uint16_t bankSlot) : slot(bankSlot) {}  // Constructor
 
-    void setValue(float value) { sensorValue = value; }; // Concrete implementation -> all sensors set the same
+    void setValue(float value) { sensor_bank_store(slot, pm_value_from_float(value), k_uptime_get_32()); }; // Concrete implementation -> all sensors set the same
+    float getValue() const { return pm_value_to_float(sensor_bank.value[slot]); }       // Non-virtual fast path
     virtual float readValue() = 0;                       // pure virtual -> read a value is sensor-specific
     virtual const char* getType() const = 0;
 
-    float getMinValue() const { return minValue; }
-    float getMaxValue() const { return maxValue; }
+    uint16_t getSlot() const { return slot; }
+    SensorType getKind() const { return static_cast<SensorType>(sensor_layout.type[slot]); }
+    uint16_t getNumber() const { return sensor_layout.number[slot]; }
+    float getMinValue() const { return pm_value_to_float(sensor_layout.min[slot]); }
+    float getMaxValue() const { return pm_value_to_float(sensor_layout.max[slot]); }
 
     virtual ~Sensor() = default;                            // Virtual destructor for proper cleanup
 };
@@ -41,62 +46,90 @@ public:
 // Temperature sensor
 class TempSensor : public Sensor {
 public:
-    TempSensor() : Sensor(0, 0.0f, 0.0f) {}
-    explicit TempSensor(uint16_t number, float min, float max) 
-        : Sensor(number, min, max) {}
-    float readValue() override { return sensorValue; }                  // Provide own implementation
-    const char* getType() const override { return "Temperature"; }
+    explicit TempSensor(uint16_t bankSlot) : Sensor(bankSlot) {}
+    float readValue() override { return getValue(); }                  // Provide own implementation
+    const char* getType() const override { return sensor_type_name(SENSOR_TEMPERATURE); }
 };
 
 // Pressure sensor
 class PressureSensor : public Sensor {
 public:
-    PressureSensor() : Sensor(0, 0.0f, 0.0f) {}
-    explicit PressureSensor(uint16_t number, float min, float max) 
-        : Sensor(number, min, max) {}
-    float readValue() override { return sensorValue; }
-    const char* getType() const override { return "Pressure"; }
+    explicit PressureSensor(uint16_t bankSlot) : Sensor(bankSlot) {}
+    float readValue() override { return getValue(); }
+    const char* getType() const override { return sensor_type_name(SENSOR_PRESSURE); }
 };
 
 // Vibration sensor
 class VibrationSensor : public Sensor {
 public:
-    VibrationSensor() : Sensor(0, 0.0f, 0.0f) {}
-    explicit VibrationSensor(uint16_t number, float min, float max)
-        : Sensor(number, min, max) {}
-    float readValue() override { return sensorValue; }
-    const char* getType() const override { return "Vibration"; }
-};
-
-// Factory class
-class SensorFactory {
-public:
-    static Sensor* createSensor(const char* type, uint16_t sensorNumber, 
-                                float minValue, float maxValue);
+    explicit VibrationSensor(uint16_t bankSlot) : Sensor(bankSlot) {}
+    float readValue() override { return getValue(); }
+    const char* getType() const override { return sensor_type_name(SENSOR_VIBRATION); }
 };
 
+// A machine - a named, contiguous range of sensor slots. Built at compile time from topology.h.
 class Machine {
 private:
-    Sensor* sensors[MAX_SENSORS];
-    uint8_t sensorCount;
-
-public: 
+    uint16_t firstSlot;                                     // First sensor slot owned by this machine
+    uint8_t  typeIndex[SENSOR_TYPE_COUNT];                  // SensorType -> index within the machine
+    uint8_t  sensorCount;                                   // Slots [firstSlot, firstSlot + sensorCount)
+    uint16_t index;                                         // Position in the registry's machine pool
+    uint16_t id;                                            // Plant-wide machine ID
     const char* name;
     MachineType type;
 
-    explicit Machine(const char* machineName, MachineType machineType);
-
-    void addSensor(Sensor* sensor);
-    void setSensorValue(const char* sensorType, float value);
+public: 
+    constexpr Machine()                                     // Unused pool entry
+        : Machine(UINT16_MAX, UINT16_MAX, "unknown", AIR_COMPRESSOR) {}
+
+    constexpr Machine(uint16_t poolIndex, uint16_t machineId, const char* machineName, MachineType machineType)
+        : firstSlot(SENSOR_SLOT_NONE), typeIndex{}, sensorCount(0U), index(poolIndex), id(machineId),
+          name(machineName), type(machineType)
+    {
+        for (uint8_t t = 0U; t < SENSOR_TYPE_COUNT; t++) {
+            typeIndex[t] = SENSOR_INDEX_NONE;
+        }
+    }
+
+    // Append the next slot of the machine's range (compile-time construction only)
+    constexpr void addSlot(uint16_t slot, SensorType kind)
+    {
+        if (sensorCount == 0U) {
+            firstSlot = slot;
+        }
+        // First sensor of each type wins the typed lookup slot
+        if (typeIndex[kind] == SENSOR_INDEX_NONE) {
+            typeIndex[kind] = sensorCount;
+        }
+        sensorCount++;
+    }
+
+    uint8_t findSensor(SensorType sensorType) const;
+
+    // String-keyed access (kept for compatibility - resolves the name once, then O(1))
+    void setSensorValue(const char* sensorType, float value) const;
     float getSensorValue(const char* sensorType) const;
     float getSensorMinValue(const char* sensorType) const;
     float getSensorMaxValue(const char* sensorType) const;
+
+    // Index-keyed O(1) access straight into the sensor bank (the machine itself is immutable)
+    void setSensorValueAt(uint8_t sensorIndex, float value) const;
+    float getSensorValueAt(uint8_t sensorIndex) const;
+    float getSensorMinValueAt(uint8_t sensorIndex) const;
+    float getSensorMaxValueAt(uint8_t sensorIndex) const;
+    SensorType getSensorKind(uint8_t sensorIndex) const;
+
     const char* getSensorType(uint8_t sensorIndex) const;
+    uint16_t getSensorId(uint8_t sensorIndex) const;
+    uint16_t getSensorSlot(uint8_t sensorIndex) const;
 
+    uint16_t getIndex() const { return index; }
+    uint16_t getId() const { return id; }
     const char* getName() const { return name; }
     MachineType getType() const { return type; }
     uint8_t getSensorCount() const { return sensorCount; }
+    uint16_t getFirstSlot() const { return firstSlot; }
 };
 
 
-#endif // SENSOR_H
\ No newline at end of file
+#endif // SENSOR_H
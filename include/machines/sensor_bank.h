@@ -0,0 +1,154 @@
+#ifndef SENSOR_BANK_H
+#define SENSOR_BANK_H
+
+/**
+ * @file sensor_bank.h
+ * @brief Structure-of-arrays storage for every sensor in the fleet.
+ *
+ * Each sensor owns one slot. Its range, type and owner live at the same
+ * index of parallel contiguous arrays, so acquisition and detection can
+ * sweep the whole fleet linearly without pointer chasing or virtual calls.
+ * Machines own a contiguous range of slots. Values and ranges are
+ * pm_value_t - Q16.16 integers with CONFIG_PM_FIXED_POINT.
+ *
+ * The static part (SensorLayout) is generated from the fleet topology at
+ * compile time and lives in ROM; only the live part (SensorBank) is RAM.
+ *
+ * The live values are guarded per machine by a sequence lock instead of
+ * a mutex: a writer bumps the machine's sequence to odd, stores, and
+ * bumps it back to even; readers copy whatever they need and retry if
+ * the sequence was odd or moved. Readers never block the writer, and a
+ * reader gets every sensor of a machine from the same point in time.
+ * All writes go through sensor_bank_store_n() - Thread 1 publishes all
+ * sensors of a machine due on one tick in a single write - or the
+ * single-slot sensor_bank_store() of the wrapper setters. Both serialize
+ * writers with a short spinlock, stamp the values and mark them for
+ * collection.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+
+#include "wrapper.h"
+#include "fixed_point.h"
+
+/** @brief Per-type sensor capacity (Kconfig: CONFIG_PM_MAX_*_SENSORS) */
+#define MAX_TEMP_SENSORS    ((uint32_t)CONFIG_PM_MAX_TEMP_SENSORS)
+#define MAX_PRESS_SENSORS   ((uint32_t)CONFIG_PM_MAX_PRESS_SENSORS)
+#define MAX_VIB_SENSORS     ((uint32_t)CONFIG_PM_MAX_VIB_SENSORS)
+
+/** @brief Total sensor capacity of the fleet (sum of the per-type capacities) */
+#define MAX_FLEET_SENSORS   (MAX_TEMP_SENSORS + MAX_PRESS_SENSORS + MAX_VIB_SENSORS)
+
+/** @brief Machine capacity of the fleet (Kconfig: CONFIG_PM_MAX_MACHINES) */
+#define MAX_FLEET_MACHINES  ((uint32_t)CONFIG_PM_MAX_MACHINES)
+
+// Default sampling periods per sensor type - here rather than in sensor.h so C stages can derive rates from them
+#define TEMP_SAMPLE_PERIOD_MS   1000U   // 1 Hz - thermal time constants are seconds to minutes
+#define PRESS_SAMPLE_PERIOD_MS  100U    // 10 Hz
+#define VIB_SAMPLE_PERIOD_MS    1U      // 1 kHz - needed for spectral analysis
+
+/** @brief Marks an invalid sensor slot */
+#define SENSOR_SLOT_NONE    0xFFFFU
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Static description of every slot, indexed by sensor slot.
+ *
+ * Slots [0, count) are valid. Read-only - generated from topology.h.
+*/
+typedef struct SensorLayout {
+    pm_value_t min[MAX_FLEET_SENSORS];      /**< Lower bound of the valid operating range */
+    pm_value_t max[MAX_FLEET_SENSORS];      /**< Upper bound of the valid operating range */
+    uint16_t number[MAX_FLEET_SENSORS];     /**< Fleet-unique sensor number */
+    uint8_t  type[MAX_FLEET_SENSORS];       /**< SensorType */
+    uint16_t machine[MAX_FLEET_SENSORS];    /**< Pool index of the owning machine (see get_machine()) */
+    uint8_t  index[MAX_FLEET_SENSORS];      /**< Position of the sensor within its machine */
+    uint32_t period_ms[MAX_FLEET_SENSORS];  /**< Sampling period of the sensor */
+    uint16_t count;                         /**< Number of sensors in the fleet */
+} SensorLayout;
+
+/**
+ * @brief Live per-slot state, indexed by sensor slot.
+*/
+typedef struct SensorBank {
+    pm_value_t value[MAX_FLEET_SENSORS];    /**< Current sensor reading */
+    uint32_t timestamp_ms[MAX_FLEET_SENSORS];   /**< Acquisition time of value[] (ms since boot) */
+    atomic_t updated[ATOMIC_BITMAP_SIZE(MAX_FLEET_SENSORS)];   /**< Bit per slot: new value not yet collected */
+    atomic_t overwritten;                   /**< Values replaced before they were collected (consumed by sensor_read) */
+    atomic_t seq[MAX_FLEET_MACHINES];       /**< Per-machine sequence lock - odd while a write is in progress */
+} SensorBank;
+
+/** @brief Fleet sensor layout (ROM) */
+extern const SensorLayout sensor_layout;
+
+/** @brief Global sensor bank holding the live state of all sensors */
+extern SensorBank sensor_bank;
+
+/**
+ * @brief Start updating the sensors of one machine (writer side only).
+ *
+ * Only one writer may be between begin and end - sensor_bank_store_n()
+ * guarantees it.
+ *
+ * @param machine Pool index of the machine (sensor_layout.machine[slot]).
+*/
+static inline void sensor_bank_write_begin(uint16_t machine)
+{
+    (void)atomic_inc(&sensor_bank.seq[machine]);
+    barrier_dmem_fence_full();      // Odd sequence visible before the data changes
+}
+
+/**
+ * @brief Publish the updates made since sensor_bank_write_begin().
+*/
+static inline void sensor_bank_write_end(uint16_t machine)
+{
+    barrier_dmem_fence_full();      // Data visible before the sequence turns even
+    (void)atomic_inc(&sensor_bank.seq[machine]);
+}
+
+/**
+ * @brief Start a lock-free read of one machine's sensors.
+ *
+ * @return Sequence to hand to sensor_bank_read_retry()
+*/
+static inline uint32_t sensor_bank_read_begin(uint16_t machine)
+{
+    uint32_t seq = (uint32_t)atomic_get(&sensor_bank.seq[machine]);
+    barrier_dmem_fence_full();
+    return seq;
+}
+
+/**
+ * @brief Check whether the data read since sensor_bank_read_begin() may be torn.
+ *
+ * Writes run under sensor_bank_store_n()'s spinlock, which on a single core
+ * also locks out preemption, so a reader is never spinning while a write
+ * is in progress.
+ *
+ * @return true if the read must be repeated
+*/
+static inline bool sensor_bank_read_retry(uint16_t machine, uint32_t seq)
+{
+    barrier_dmem_fence_full();
+    return ((seq & 1U) != 0U) || ((uint32_t)atomic_get(&sensor_bank.seq[machine]) != seq);
+}
+
+/** Function prototypes */
+void sensor_bank_store(uint16_t slot, pm_value_t value, uint32_t timestamp_ms);
+void sensor_bank_store_n(uint16_t machine, const uint16_t *slots, const pm_value_t *values,
+                         uint32_t count, uint32_t timestamp_ms);
+uint8_t sensor_bank_snapshot(uint16_t machine, uint16_t first_slot, uint8_t count,
+                             pm_value_t *value, uint32_t *timestamp_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_BANK_H
@@ -0,0 +1,176 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+/**
+ * @file topology.h
+ * @brief The fleet - every machine and sensor, declared once at compile time.
+ *
+ * The sensor layout and the registry are generated from these tables by
+ * the compiler and placed in ROM, so the fleet needs no construction at
+ * boot. The static_asserts below turn a misconfigured fleet (capacity
+ * overflow, duplicate IDs, dangling or scattered sensors, bad ranges)
+ * into a build error.
+*/
+
+#include <stdint.h>
+
+#include "wrapper.h"
+#include "sensor.h"
+#include "registry.h"
+
+/**
+ * @brief One machine of the fleet.
+*/
+struct MachineConfig {
+    uint16_t    id;                 // Plant-wide machine ID
+    const char* name;
+    MachineType type;
+};
+
+/**
+ * @brief One sensor of the fleet.
+ *
+ * Sensors of a machine are listed back to back; the position in the table
+ * is the sensor's bank slot.
+*/
+struct SensorConfig {
+    uint16_t   machineId;           // ID of the owning machine
+    SensorType type;
+    uint16_t   number;              // Fleet-unique sensor number
+    float      minValue;
+    float      maxValue;
+    uint32_t   periodMs;
+};
+
+// Machines - the position in the table is the machine's pool index
+inline constexpr MachineConfig machineTable[] = {
+    { 0U, "Station_A_Air_Compressor", AIR_COMPRESSOR },
+    { 1U, "Station_A_Steam_Boiler",   STEAM_BOILER   },
+    { 2U, "Station_A_Electric_Motor", ELECTRIC_MOTOR },
+};
+
+// Sensors - each sampled at the default rate of its type (1 Hz / 10 Hz / 1 kHz)
+inline constexpr SensorConfig sensorTable[] = {
+    // Air Compressor: Temperature (60-100°C), Pressure (72-145 psi), Vibration (0.5-2.0 mm/s)
+    { 0U, SENSOR_TEMPERATURE, 0U,  60.0f, 100.0f, TEMP_SAMPLE_PERIOD_MS  },
+    { 0U, SENSOR_PRESSURE,    1U,  72.0f, 145.0f, PRESS_SAMPLE_PERIOD_MS },
+    { 0U, SENSOR_VIBRATION,   2U,   0.5f,   2.0f, VIB_SAMPLE_PERIOD_MS   },
+
+    // Steam Boiler: Temperature (150-250°C), Pressure (87-360 psi)
+    { 1U, SENSOR_TEMPERATURE, 3U, 150.0f, 250.0f, TEMP_SAMPLE_PERIOD_MS  },
+    { 1U, SENSOR_PRESSURE,    4U,  87.0f, 360.0f, PRESS_SAMPLE_PERIOD_MS },
+
+    // Electric Motor: Temperature (60-105°C)
+    { 2U, SENSOR_TEMPERATURE, 5U,  60.0f, 105.0f, TEMP_SAMPLE_PERIOD_MS  },
+};
+
+inline constexpr uint32_t FLEET_MACHINES = sizeof(machineTable) / sizeof(machineTable[0]);
+inline constexpr uint32_t FLEET_SENSORS  = sizeof(sensorTable) / sizeof(sensorTable[0]);
+
+namespace topology {
+
+// Pool index of a machine ID, or MACHINE_INDEX_NONE
+constexpr uint32_t machineIndex(uint16_t machineId)
+{
+    for (uint32_t m = 0U; m < FLEET_MACHINES; m++) {
+        if (machineTable[m].id == machineId) {
+            return m;
+        }
+    }
+    return MACHINE_INDEX_NONE;
+}
+
+constexpr uint32_t sensorsOfType(SensorType type)
+{
+    uint32_t n = 0U;
+    for (const SensorConfig& s : sensorTable) {
+        n += (s.type == type) ? 1U : 0U;
+    }
+    return n;
+}
+
+constexpr bool machineIdsUnique()
+{
+    for (uint32_t m = 0U; m < FLEET_MACHINES; m++) {
+        if (machineTable[m].id == MACHINE_INDEX_NONE || machineIndex(machineTable[m].id) != m) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool sensorNumbersUnique()
+{
+    for (uint32_t i = 0U; i < FLEET_SENSORS; i++) {
+        if (sensorTable[i].number == SENSOR_SLOT_NONE) {
+            return false;
+        }
+        for (uint32_t j = 0U; j < i; j++) {
+            if (sensorTable[j].number == sensorTable[i].number) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Every sensor belongs to a listed machine and is a valid, ordered range
+constexpr bool sensorsValid()
+{
+    for (const SensorConfig& s : sensorTable) {
+        if (machineIndex(s.machineId) == MACHINE_INDEX_NONE || (unsigned int)s.type >= SENSOR_TYPE_COUNT ||
+            !(s.minValue < s.maxValue) || s.periodMs == 0U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A machine owns a contiguous range of slots: once left, it never reappears
+constexpr bool sensorsGrouped()
+{
+    for (uint32_t i = 1U; i < FLEET_SENSORS; i++) {
+        if (sensorTable[i].machineId == sensorTable[i - 1U].machineId) {
+            continue;
+        }
+        for (uint32_t j = 0U; j < i; j++) {
+            if (sensorTable[j].machineId == sensorTable[i].machineId) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Every machine has at least one sensor and at most MAX_SENSORS
+constexpr bool machinesPopulated()
+{
+    for (const MachineConfig& mc : machineTable) {
+        uint32_t n = 0U;
+        for (const SensorConfig& s : sensorTable) {
+            n += (s.machineId == mc.id) ? 1U : 0U;
+        }
+        if (n == 0U || n > MAX_SENSORS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace topology
+
+static_assert(FLEET_MACHINES <= MAX_MACHINES, "Topology exceeds CONFIG_PM_MAX_MACHINES");
+static_assert(FLEET_SENSORS <= MAX_FLEET_SENSORS, "Topology exceeds the sensor bank capacity");
+static_assert(topology::sensorsOfType(SENSOR_TEMPERATURE) <= MAX_TEMP_SENSORS,
+              "Topology exceeds CONFIG_PM_MAX_TEMP_SENSORS");
+static_assert(topology::sensorsOfType(SENSOR_PRESSURE) <= MAX_PRESS_SENSORS,
+              "Topology exceeds CONFIG_PM_MAX_PRESS_SENSORS");
+static_assert(topology::sensorsOfType(SENSOR_VIBRATION) <= MAX_VIB_SENSORS,
+              "Topology exceeds CONFIG_PM_MAX_VIB_SENSORS");
+static_assert(topology::machineIdsUnique(), "Duplicate or reserved machine ID in the topology");
+static_assert(topology::sensorNumbersUnique(), "Duplicate or reserved sensor number in the topology");
+static_assert(topology::sensorsValid(), "Sensor with unknown machine, bad type, empty range or zero period");
+static_assert(topology::sensorsGrouped(), "Sensors of a machine must be listed back to back");
+static_assert(topology::machinesPopulated(), "Machine with no sensors or more than CONFIG_PM_MAX_SENSORS_PER_MACHINE");
+
+#endif // TOPOLOGY_H
@@ -7,8 +7,7 @@
 */
 
 #include <stdint.h>
-
-#define NUM_MACHINES        3U
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,19 +25,81 @@ typedef enum {
     ELECTRIC_MOTOR
 } MachineType;
 
-// Opaque handle for Machine objects
+/**
+ * @enum SensorType
+ * @brief Enumeration of supported sensor types.
+ * 
+ * Replaces string keys on the hot path - see sensor_type_name() for
+ * the display name of each type.
+*/
+typedef enum {
+    SENSOR_TEMPERATURE,
+    SENSOR_PRESSURE,
+    SENSOR_VIBRATION,
+    SENSOR_TYPE_COUNT           /**< Number of sensor types / invalid marker */
+} SensorType;
+
+// Opaque handle for Machine objects - machines are immutable (ROM), only sensor values change
 typedef void* MachineHandle;
 
-// Initialization
-void generate_machines_and_sensors(void);
+/** @brief Sensors one machine snapshot can hold (Kconfig: CONFIG_PM_MAX_SENSORS_PER_MACHINE) */
+#define MACHINE_SNAPSHOT_SENSORS    ((uint32_t)CONFIG_PM_MAX_SENSORS_PER_MACHINE)
 
-// Machine access
-MachineHandle get_machine(uint8_t index);
+/**
+ * @brief Everything known about one sensor, copied out in a single call.
+ *
+ * Plain data - filled by get_machine_snapshot() / read_all_sensors().
+*/
+typedef struct {
+    uint16_t id;                /**< Fleet-unique sensor number */
+    uint16_t slot;              /**< Sensor bank slot */
+    uint8_t  type;              /**< SensorType */
+    float    value;             /**< Current reading */
+    float    min;               /**< Lower bound of the valid operating range */
+    float    max;               /**< Upper bound of the valid operating range */
+    uint32_t timestamp_ms;      /**< Acquisition time of value (ms since boot) */
+} SensorSnapshot;
+
+/**
+ * @brief One machine and all its sensors, values taken from the same instant.
+*/
+typedef struct {
+    uint16_t       machineId;   /**< Plant-wide machine ID */
+    MachineType    type;
+    const char*    name;
+    uint8_t        sensorCount; /**< Valid entries in sensors[] */
+    SensorSnapshot sensors[MACHINE_SNAPSHOT_SENSORS];
+} MachineSnapshot;
+
+// Machine access - by pool index (0 .. get_machine_count() - 1) or by ID
+uint16_t get_machine_count(void);
+MachineHandle get_machine(uint16_t index);
+MachineHandle find_machine(uint16_t machineId);
+uint16_t get_machine_id(MachineHandle machine);
+uint16_t find_sensor_slot(uint16_t sensorNumber);
 const char* get_machine_name(MachineHandle machine);
 MachineType get_machine_type(MachineHandle machine);
 uint8_t get_sensor_count(MachineHandle machine);
 
-// Sensor Operations
+// Batch access - one call per machine / per fleet sweep instead of several per sensor
+uint8_t get_machine_snapshot(MachineHandle machine, MachineSnapshot* out);
+uint32_t read_all_sensors(SensorSnapshot* out, uint32_t maxCount);
+
+// Sensor type names
+const char* sensor_type_name(SensorType type);
+SensorType sensor_type_from_name(const char* name);
+
+// Sensor Operations - index-keyed, O(1), no string comparison
+SensorType get_sensor_kind(MachineHandle machine, uint8_t sensorIndex);
+uint8_t get_sensor_index(MachineHandle machine, SensorType sensorType);
+uint16_t get_sensor_id(MachineHandle machine, uint8_t sensorIndex);
+uint16_t get_sensor_slot(MachineHandle machine, uint8_t sensorIndex);
+void set_sensor_value_at(MachineHandle machine, uint8_t sensorIndex, float value);
+float get_sensor_value_at(MachineHandle machine, uint8_t sensorIndex);
+float get_sensor_min_value_at(MachineHandle machine, uint8_t sensorIndex);
+float get_sensor_max_value_at(MachineHandle machine, uint8_t sensorIndex);
+
+// Sensor Operations - string-keyed (legacy)
 const char* get_sensor_type(MachineHandle machine, uint8_t sensorIndex);
 void set_sensor_value(MachineHandle machine, const char* sensorType, float value);
 float get_sensor_value(MachineHandle machine, const char* sensorType);
@@ -8,42 +8,151 @@
 
 #include <zephyr/kernel.h>
 
+#include "fixed_point.h"
+#include "latency.h"
+#include "history.h"
+
+/** @brief Size of the text buffer the system logger formats each record into */
 #define LOG_MSG_SIZE                128
 #define LOG_QUEUE_SIZE              32
 
+/** @brief Channels sampled faster than this are not logged sample by sample */
+#define LOG_SAMPLE_MIN_PERIOD_MS    1000U
+
+/** @brief Raw arguments carried by one log record */
+#define LOG_MAX_ARGS                6
+
 /** @brief Memory alignment for the message queue buffer in bytes */
 #define MESSAGE_ALIGN               4
 
 /** @brief Global message queue for serialized terminal logging  */
 extern struct k_msgq log_queue;
 
-extern struct k_mutex sensor_mutex;
-extern struct k_mutex buffer_mutex;
+/** @brief Max pending anomaly events between Thread 3 and Thread 4 */
+#define ANOMALY_QUEUE_SIZE          16
+
+/** @brief Pipeline hand-off signals (binary semaphores - repeated gives coalesce) */
+extern struct k_sem sensor_update_sem;      /**< Thread 1 -> Thread 2: sensor sweep complete */
+extern struct k_sem buffer_data_sem;        /**< Thread 2 -> Thread 3: readings in the circular buffer */
+extern struct k_sem store_data_sem;         /**< Thread 2 -> Thread 7: readings in the circular buffer */
+extern struct k_sem store_page_sem;         /**< Thread 7 -> Thread 6: full history pages to program */
+extern struct k_sem buffer_space_sem;       /**< Threads 3, 7 -> Thread 2: circular buffer entries released */
+
+/** @brief Queue of detected anomalies from Thread 3 to Thread 4 */
+extern struct k_msgq anomaly_queue;
+
+/** @brief Acquisition-to-alert latency of every handled anomaly (recorded by Thread 4) */
+extern latency_hist_t alert_latency;
+
+/** @brief Compressed recent history of every sensor, indexed by slot (MAX_FLEET_SENSORS entries, appended by Thread 3) */
+extern history_t sensor_history[];
+
+/** @brief Histograms reported in LOG_FMT_LATENCY records (the record's slot field) */
+typedef enum {
+    LATENCY_SAMPLE_AGE,         /**< Sample age when it reached detection */
+    LATENCY_SAMPLE_TO_ALERT     /**< Sample acquisition to handled alert */
+} latency_report_t;
+
+/**
+ * @brief Format IDs of deferred log records.
+ *
+ * Each ID selects a format string in the system logger (thread 5), the
+ * only place where text is produced. Sensor names and ranges are resolved
+ * there from the record's sensor slot. Sensor values, z-scores, window
+ * and rollup statistics travel as LOG_ARG_VALUE() (pm_value_t); spectral
+ * features are always float.
+*/
+typedef enum {
+    LOG_FMT_SENSOR_VALUE,       /**< slot; args: value */
+    LOG_FMT_OVERWRITTEN,        /**< Readings lapped while being processed */
+    LOG_FMT_INVALID,            /**< args: readings dropped for an unknown sensor ID, total dropped */
+    LOG_FMT_READING,            /**< slot; args: value, z-score, acquisition ms, LOG_FLAG_* */
+    LOG_FMT_WINDOW,             /**< slot; args: length, mean, min, max, rms */
+    LOG_FMT_SPECTRUM,           /**< slot; args: 1x, 2x, bearing, total, peak Hz, LOG_FLAG_* */
+    LOG_FMT_ANOMALY_ALERT,      /**< slot; args: value, z-score, acquisition ms, LOG_FLAG_* */
+    LOG_FMT_SEQ_GAP,            /**< args: expected sequence, received sequence, readings lost */
+    LOG_FMT_ROLLUP,             /**< slot; args: window start ms, LOG_ROLLUP_PACK(level, count), min, max, mean, last */
+    LOG_FMT_LATENCY,            /**< slot: latency_report_t; args: count, p50 us, p99 us, max us */
+    LOG_FMT_READER,             /**< slot: circular buffer reader index; args: lag, overruns */
+    LOG_FMT_STAGE_STATS,        /**< slot: instr_stage_t; args: count, p50 us, p99 us, max us */
+    LOG_FMT_THREAD_CPU,         /**< slot: instrumented thread index; args: CPU share in permille */
+    LOG_FMT_COUNT
+} log_fmt_t;
+
+/** @brief Flags carried in the flag argument of reading/spectrum records */
+#define LOG_FLAG_OUT_OF_RANGE       (1U << 0)
+#define LOG_FLAG_OUTLIER            (1U << 1)
+
+/** @brief Rollup level (top 4 bits) and sample count (low 28 bits) in one argument */
+#define LOG_ROLLUP_PACK(level, count)   (((uint32_t)(level) << 28) | ((uint32_t)(count) & 0x0FFFFFFFU))
+#define LOG_ROLLUP_LEVEL(arg)           ((uint32_t)(arg) >> 28)
+#define LOG_ROLLUP_COUNT(arg)           ((uint32_t)(arg) & 0x0FFFFFFFU)
+
+/** @brief One raw log argument - interpreted according to the record's format ID */
+typedef union {
+    float    f;
+    uint32_t u;
+    int32_t  i;
+} log_arg_t;
+
+/** @brief Log argument carrying a pm_value_t - converted to float by the logger only */
+#ifdef CONFIG_PM_FIXED_POINT
+#define LOG_ARG_VALUE(v)            {.i = (v)}
+#else
+#define LOG_ARG_VALUE(v)            {.f = (v)}
+#endif
 
 /** 
  * @brief Log message structure for inter-thread communication
  * 
- * Passed through the logging message queue from threads 1-4
- * to the system logger (thread 5) for terminal output.
+ * Tiny binary record passed through the logging message queue from
+ * threads 1-4 to the system logger (thread 5). Producers only fill in
+ * raw values; all formatting happens in the logger at the lowest priority.
 */
 typedef struct {
-    int thread_id;                      /**< ID of the thread that emitted the message */
-    char message[LOG_MSG_SIZE];         /**< Null-terminated log message string */
+    uint8_t   fmt;                      /**< log_fmt_t selecting the format string */
+    uint8_t   thread_id;                /**< ID of the thread that emitted the message */
+    uint16_t  slot;                     /**< Sensor bank slot the record refers to (if any) */
+    uint32_t  timestamp_ms;             /**< Uptime when the record was emitted */
+    log_arg_t args[LOG_MAX_ARGS];       /**< Raw arguments */
 } log_msg_t;
 
+/**
+ * @brief Stamp a log record and queue it for the system logger without blocking.
+ *
+ * @param msg Record with fmt, thread_id, slot and args filled in.
+*/
+static inline void log_post(log_msg_t *msg)
+{
+    msg->timestamp_ms = k_uptime_get_32();
+    (void)k_msgq_put(&log_queue, msg, K_NO_WAIT);
+}
+
+/**
+ * @brief Anomaly detected by Thread 3, handed to Thread 4 through anomaly_queue.
+*/
+typedef struct {
+    uint16_t slot;              /**< Sensor bank slot of the anomalous sensor */
+    uint16_t flags;             /**< LOG_FLAG_OUT_OF_RANGE / LOG_FLAG_OUTLIER */
+    pm_value_t value;           /**< Offending sensor value */
+    pm_value_t zscore;          /**< z-score against the sensor's running statistics */
+    uint32_t timestamp_ms;      /**< Acquisition time of the reading */
+} anomaly_event_t;
+
 /**
  * @brief Represents a single sensor reading from a machine.
  * 
- * Stores the machine and sensor identity alongside the recorded value
- * and its valid operating range. Used as the unit of data passed
- * through the circular buffer from Thread 2 to Thread 3.
+ * Compact binary record used as the unit of data passed through the
+ * circular buffer from Thread 2 to Thread 3. Identity is carried as
+ * small integer IDs rather than strings - the owning machine, names and
+ * valid operating ranges are looked up from the sensor layout by the
+ * stages that need them.
 */
 struct sensor_reading { 
-    char machine_name[30];      /**< Name of the machine this reading belongs to */
-    char sensor_type[16];       /**< Name of the sensor that produced the reading */
-    float value;                /**< Recorded sensor value */
-    float min_value;            /**< Minimum value of the sensor's valid operating range */
-    float max_value;            /**< Maximum value of the sensor's valid operating range */
+    uint32_t timestamp_ms;      /**< Monotonic acquisition time (ms since boot) */
+    pm_value_t value;           /**< Recorded sensor value (Q16.16 with CONFIG_PM_FIXED_POINT) */
+    uint16_t sensor_id;         /**< Fleet-unique sensor ID (sensor bank slot) */
+    uint16_t seq;               /**< Acquisition sequence number (wraps) - gaps mark lost readings */
 };
 
 #endif // SHARED_RESOURCES_H
\ No newline at end of file
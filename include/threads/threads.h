@@ -6,10 +6,35 @@
  * @brief 
 */
 
-#define THREAD_SENSOR_WRITE_PERIOD_MS       (30000U)
-#define THREAD_SENSOR_READ_PERIOD_MS        (30000U)
-#define THREAD_ANOMALY_DETECT_PERIOD_MS     (30000U)
-#define THREAD_ANOMALY_HANDLE_PERIOD_MS     (30000U)
+/*
+ * Sampling rates are per sensor (SensorBank.period_ms) and driven by the
+ * timer wheel in sensor_write; all later stages are event-driven.
+ */
+
+/** @brief Shortest rollup level (rollup_level_t) posted to the logger (Kconfig, default 1 s) */
+#define THREAD_ROLLUP_LOG_MIN_LEVEL         CONFIG_PM_ROLLUP_LOG_MIN_LEVEL
+
+/** @brief How often Thread 3 closes the rollup windows of sensors that went quiet */
+#define THREAD_ROLLUP_EXPIRE_PERIOD_MS      1000U
+
+/**
+ * @brief How far behind the clock Thread 3 closes rollup windows - covers
+ *        readings still in the circular buffer (sample age p99 is reported
+ *        every THREAD_LATENCY_REPORT_PERIOD_MS); later ones are counted as late
+*/
+#define THREAD_ROLLUP_EXPIRE_GRACE_MS       2000U
+
+/** @brief Period of the sample age / sample-to-alert latency / reader lag report (Thread 3) */
+#define THREAD_LATENCY_REPORT_PERIOD_MS     10000U
+
+/**
+ * @brief Longest Thread 2 waits at the buffer high-water mark for its readers -
+ *        a reader stalled beyond it is lapped instead of stopping acquisition
+*/
+#define THREAD_BUFFER_SPACE_TIMEOUT_MS      5U
+
+/** @brief Readings Thread 7 copies out of the circular buffer per read */
+#define THREAD_STORE_DRAIN_BATCH            16U
 
 // Function Prototypes
 void sensor_write(void);
@@ -17,5 +42,7 @@ void sensor_read(void);
 void anomaly_detect(void);
 void anomaly_handle(void);
 void system_log(void);
+void store_write(void);
+void store_fill(void);
 
 #endif // THREADS_H
\ No newline at end of file
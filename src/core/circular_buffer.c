@@ -1,94 +1,547 @@
 /**
 * @file circular_buffer.c
-* @brief Circular buffer implementation for storing sensor data.
+* @brief Lock-free circular buffer implementation for storing sensor data.
 *
-* This module provides a FIFO circular buffer with overwrite-on-full behaviour.
-* It is intended for producer-consumer pipelines where old sensor data is dropped
-* when the buffer reaches capacity. 
+* This module provides a FIFO broadcast ring for exactly one producer
+* thread and several reader threads. Each reader registered with
+* cb_reader_register() owns a tail and sees every entry in order, so
+* detection, persistence and any later consumer share one copy of the
+* data. No mutex is needed: the producer only ever stores head and claim,
+* each reader only ever stores its own tail, and all of them are
+* published with atomic operations.
+*
+* Besides the copying cb_write()/cb_read(), a zero-copy path lets the
+* producer fill a reserved slot in place and a reader process a
+* contiguous span where it sits. Bulk cb_write_n()/cb_read_n() move a whole
+* sensor sweep with a single publish or release.
+*
+* Two full-buffer policies are offered:
+*  - CB_OVERWRITE_OLDEST: the producer never waits or fails, however far
+*    behind a reader is. It announces the slots it is about to fill in
+*    claim before touching them. A reader detects that it has been lapped,
+*    skips the lost entries (counted as its overruns) and validates every
+*    copy against a second read of claim (seqlock style), so a slot
+*    overwritten mid-copy is never returned.
+*  - CB_DROP_NEWEST: the producer rejects the write when the slowest
+*    reader has no free slot left.
 */
 
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
+#include <zephyr/sys/barrier.h>
 
 #include "circular_buffer.h"
 
+BUILD_ASSERT(IS_POWER_OF_TWO(BUFFER_SIZE), "BUFFER_SIZE must be a power of two for mask indexing");
+BUILD_ASSERT(sizeof(struct sensor_reading) == 12U, "sensor_reading must stay a compact 12-byte record");
+
 /**
 * @brief Initialize the circular buffer
 *
-* Sets the head and tail indices to zero, marking the buffer as empty.
+* Sets the head and claim counters to zero, marking the buffer as empty,
+* and removes every reader. Must be called before the producer and reader
+* threads are started.
+*
+* @param cb     Pointer to the CircularBuffer instance.
+* @param policy Behaviour of cb_write() when the buffer is full.
+*/
+void circular_buffer_init(CircularBuffer *cb, cb_policy_t policy) 
+{
+    if (cb == NULL) {
+        return;
+    }
+
+    (void)atomic_set(&cb->head, 0);
+    (void)atomic_set(&cb->claim, 0);
+    (void)atomic_set(&cb->readers, 0);
+    (void)atomic_set(&cb->dropped, 0);
+    cb->policy = policy;
+}
+
+/**
+* @brief Register a reader with its own read position.
+*
+* The reader starts at the current head: it sees every entry published
+* from now on. Register readers from one thread (normally before the
+* threads are started); the producer may already be running.
+*
+* @param cb   Pointer to the CircularBuffer instance.
+* @param name Short name for reports (not copied).
+* @param wake Semaphore given by cb_notify_readers(), or NULL for a polling reader.
+*
+* @return The reader handle, or NULL if CB_MAX_READERS are already registered
+*/
+cb_reader_t* cb_reader_register(CircularBuffer *cb, const char *name, struct k_sem *wake)
+{
+    if (cb == NULL) {
+        return NULL;
+    }
+
+    uint32_t n = (uint32_t)atomic_get(&cb->readers);
+    if (n >= CB_MAX_READERS) {
+        return NULL;
+    }
+
+    cb_reader_t *reader = &cb->reader[n];
+    reader->name = name;
+    reader->wake = wake;
+    (void)atomic_set(&reader->overruns, 0);
+    (void)atomic_set(&reader->tail, atomic_get(&cb->head));
+
+    // Make the reader visible to the producer only once it is complete
+    (void)atomic_set(&cb->readers, (atomic_val_t)(n + 1U));
+
+    return reader;
+}
+
+/**
+* @brief Free slots left before the slowest reader would be overwritten.
+*
+* Only meaningful in CB_DROP_NEWEST mode. With no reader registered the
+* whole buffer is free.
+*/
+static uint32_t cb_free_slots(const CircularBuffer *cb, uint32_t head)
+{
+    uint32_t n    = (uint32_t)atomic_get(&cb->readers);
+    uint32_t used = 0U;
+
+    for (uint32_t r = 0U; r < n; r++) {
+        used = MAX(used, head - (uint32_t)atomic_get(&cb->reader[r].tail));
+    }
+
+    return (used >= BUFFER_SIZE) ? 0U : (BUFFER_SIZE - used);
+}
+
+/**
+* @brief Catch a reader up with the producer.
+*
+* In CB_OVERWRITE_OLDEST mode, entries the producer has lapped (or is
+* filling right now) are skipped, counted as the reader's overruns and
+* its tail is advanced past them.
+*
+* @param cb     Pointer to the CircularBuffer instance.
+* @param reader Reader being synced.
+* @param tail   In/out reader position.
+*
+* @return Number of published entries available from *tail
+*/
+static uint32_t cb_consumer_sync(CircularBuffer *cb, cb_reader_t *reader, uint32_t *tail)
+{
+    uint32_t head = (uint32_t)atomic_get(&cb->head);
+
+    if (cb->policy == CB_OVERWRITE_OLDEST) {
+        uint32_t claim = (uint32_t)atomic_get(&cb->claim);
+
+        // Lapped by the producer - skip to the oldest entry still intact
+        if ((claim - *tail) > BUFFER_SIZE) {
+            uint32_t oldest = claim - BUFFER_SIZE;
+            (void)atomic_add(&reader->overruns, (atomic_val_t)(oldest - *tail));
+            *tail = oldest;
+            (void)atomic_set(&reader->tail, (atomic_val_t)oldest);
+        }
+    }
+
+    return head - *tail;
+}
+
+/**
+* @brief Check that entries read from tail onwards were not overwritten.
+*
+* Called after the consumer has finished with the data (seqlock style).
+* Always true in CB_DROP_NEWEST mode because the producer cannot reuse
+* a slot before every reader's tail is past it.
+*
+* @param cb   Pointer to the CircularBuffer instance.
+* @param tail Reader position the data was read from.
+*
+* @return true if the data is intact
+*/
+static bool cb_consumer_valid(CircularBuffer *cb, uint32_t tail)
+{
+    if (cb->policy == CB_DROP_NEWEST) {
+        return true;
+    }
+
+    // Order the data reads before re-checking the producer's fill counter
+    barrier_dmem_fence_full();
+    uint32_t claim = (uint32_t)atomic_get(&cb->claim);
+
+    return (claim - tail) <= BUFFER_SIZE;
+}
+
+/**
+* @brief Copy entries out of the ring starting at a counter position.
+*
+* Splits the copy in two when the range wraps around the end of entries.
+*/
+static void cb_copy_out(const CircularBuffer *cb, uint32_t from,
+                        struct sensor_reading *output, uint32_t count)
+{
+    uint32_t idx   = from & BUFFER_MASK;
+    uint32_t first = MIN(count, BUFFER_SIZE - idx);
+
+    (void)memcpy(output, &cb->entries[idx], first * sizeof(struct sensor_reading));
+    (void)memcpy(&output[first], &cb->entries[0], (count - first) * sizeof(struct sensor_reading));
+}
+
+/**
+* @brief Reserve the next slot for the producer to fill in place.
+*
+* The returned slot is not visible to the readers until cb_write_commit()
+* is called. Only one slot may be outstanding at a time.
+*
+* @note Producer side only - must not be called from more than one thread.
+*
+* @param cb Pointer to the CircularBuffer instance.
+*
+* @return Pointer to the slot to fill, or NULL if the buffer is full (CB_DROP_NEWEST)
+*/
+struct sensor_reading* cb_write_reserve(CircularBuffer *cb)
+{
+    if (cb == NULL) {
+        return NULL;
+    }
+
+    uint32_t head = (uint32_t)atomic_get(&cb->head);
+
+    if (cb->policy == CB_DROP_NEWEST && cb_free_slots(cb, head) == 0U) {
+        (void)atomic_inc(&cb->dropped);
+        return NULL;
+    }
+
+    // Announce the slot before touching it so a lapped reader can detect the overwrite
+    (void)atomic_set(&cb->claim, (atomic_val_t)(head + 1U));
+
+    return &cb->entries[head & BUFFER_MASK];
+}
+
+/**
+* @brief Publish the slot(s) filled since the last reservation.
+*
+* No-op if nothing is reserved.
+*
+* @note Producer side only.
 *
 * @param cb Pointer to the CircularBuffer instance.
 */
-void circular_buffer_init(CircularBuffer *cb) 
+void cb_write_commit(CircularBuffer *cb)
 {
     if (cb == NULL) {
         return;
     }
 
-    cb->head = 0U;
-    cb->tail = 0U;
+    // Atomic store orders the in-place writes before the new head
+    (void)atomic_set(&cb->head, atomic_get(&cb->claim));
 }
 
 /**
 * @brief Write a sensor reading into the circular buffer by value.
 * 
-* Copies the sensor reading into the buffer at the current head position.
-* If the buffer is full, the oldest entry is overwritten by advancing
-* the tail index.
+* Copies the sensor reading into the slot at the current head position
+* and then publishes it by advancing head. With CB_OVERWRITE_OLDEST the
+* oldest entry is replaced even if a reader has not read it yet; with
+* CB_DROP_NEWEST the new entry is rejected instead.
+*
+* @note Producer side only - must not be called from more than one thread.
 *
 * @param cb      Pointer to the CircularBuffer instance.
 * @param reading Pointer to the sensor_reading to copy into the buffer.
 *
-* @return void
+* @return true  if the reading was stored
+* @return false if the buffer was full (CB_DROP_NEWEST) or a NULL pointer was provided
 */
-void cb_write(CircularBuffer *cb, const struct sensor_reading *reading)
+bool cb_write(CircularBuffer *cb, const struct sensor_reading *reading)
 {
     if (cb == NULL || reading == NULL) {
-        return;
+        return false;
+    }
+
+    struct sensor_reading *slot = cb_write_reserve(cb);
+    if (slot == NULL) {
+        return false;
     }
 
     // Copy the sensor reading into the buffer at current write position
-    (void)memcpy(&cb->entries[cb->head], reading, sizeof(struct sensor_reading));
+    (void)memcpy(slot, reading, sizeof(struct sensor_reading));
+    cb_write_commit(cb);
+
+    return true;
+}
+
+/**
+* @brief Write a batch of sensor readings with a single publish.
+*
+* With CB_DROP_NEWEST only as many readings as there are free slots are
+* stored. With CB_OVERWRITE_OLDEST a batch larger than the buffer keeps
+* only its last BUFFER_SIZE readings.
+*
+* @note Producer side only.
+*
+* @param cb       Pointer to the CircularBuffer instance.
+* @param readings Array of readings to copy into the buffer.
+* @param count    Number of readings in the array.
+*
+* @return Number of readings stored
+*/
+uint32_t cb_write_n(CircularBuffer *cb, const struct sensor_reading *readings, uint32_t count)
+{
+    if (cb == NULL || readings == NULL) {
+        return 0U;
+    }
+
+    uint32_t head = (uint32_t)atomic_get(&cb->head);
 
-    // Advance head index (wrap around at BUFFER_SIZE)
-    cb->head = (cb->head + 1U) % BUFFER_SIZE;
+    if (cb->policy == CB_DROP_NEWEST) {
+        uint32_t free_slots = cb_free_slots(cb, head);
+        if (count > free_slots) {
+            (void)atomic_add(&cb->dropped, (atomic_val_t)(count - free_slots));
+            count = free_slots;
+        }
+    } else if (count > BUFFER_SIZE) {
+        // Earlier readings of the batch would be overwritten by later ones anyway
+        (void)atomic_add(&cb->dropped, (atomic_val_t)(count - BUFFER_SIZE));
+        readings += count - BUFFER_SIZE;
+        count = BUFFER_SIZE;
+    }
 
-    // If head catches up to tail, buffer was full - Advance tail to discard the oldes entry 
-    if (cb->head == cb->tail) {
-        cb->tail = (cb->tail + 1U) % BUFFER_SIZE;
+    if (count == 0U) {
+        return 0U;
     }
+
+    (void)atomic_set(&cb->claim, (atomic_val_t)(head + count));
+
+    uint32_t idx   = head & BUFFER_MASK;
+    uint32_t first = MIN(count, BUFFER_SIZE - idx);
+    (void)memcpy(&cb->entries[idx], readings, first * sizeof(struct sensor_reading));
+    (void)memcpy(&cb->entries[0], &readings[first], (count - first) * sizeof(struct sensor_reading));
+
+    (void)atomic_set(&cb->head, (atomic_val_t)(head + count));
+
+    return count;
 }
 
 /**
 * @brief Read a sensor reading from the circular buffer by value
 * 
-* Copies the oldest sensor reading into the provided output struct
-* in FIFO order.
+* Copies the reader's oldest unread sensor reading into the provided
+* output struct in FIFO order. Other readers are not affected.
+*
+* In CB_OVERWRITE_OLDEST mode entries the producer has already lapped are
+* skipped and counted as the reader's overruns, and a copy torn by a
+* concurrent overwrite is retried.
+*
+* @note Reader side only - must not be called from more than one thread per reader.
 *
 * @param cb     Pointer to the CircularBuffer instance.
+* @param reader Reader handle from cb_reader_register().
 * @param output Pointer to a sensor_reading struct to receive the copy.
 *
 * @return true  if sensor reading successfully read
 * @return false if the buffer was empty or a NULL pointer was provided
 */
-bool cb_read(CircularBuffer *cb, struct sensor_reading *output) 
+bool cb_read(CircularBuffer *cb, cb_reader_t *reader, struct sensor_reading *output) 
 {
-    if (cb == NULL || output == NULL) {
-        return false;
+    return cb_read_n(cb, reader, output, 1U) == 1U;
+}
+
+/**
+* @brief Read up to max_count sensor readings with a single release.
+*
+* @note Reader side only.
+*
+* @param cb        Pointer to the CircularBuffer instance.
+* @param reader    Reader handle from cb_reader_register().
+* @param output    Array receiving the copies in FIFO order.
+* @param max_count Capacity of the output array.
+*
+* @return Number of readings copied (0 if empty or a NULL pointer was provided)
+*/
+uint32_t cb_read_n(CircularBuffer *cb, cb_reader_t *reader, struct sensor_reading *output, uint32_t max_count)
+{
+    if (cb == NULL || reader == NULL || output == NULL || max_count == 0U) {
+        return 0U;
     }
 
-    // Buffer is empty if head equals tail
-    if (cb->head == cb->tail) {
+    uint32_t tail = (uint32_t)atomic_get(&reader->tail);
+    uint32_t count;
+
+    do {
+        uint32_t available = cb_consumer_sync(cb, reader, &tail);
+        if (available == 0U) {
+            return 0U;
+        }
+
+        count = MIN(available, max_count);
+        cb_copy_out(cb, tail, output, count);
+    } while (!cb_consumer_valid(cb, tail));
+
+    // Advance this reader's tail - the slots are released once every reader is past them
+    (void)atomic_set(&reader->tail, (atomic_val_t)(tail + count));
+
+    return count;
+}
+
+/**
+* @brief Get the longest contiguous span of unread entries without copying.
+*
+* The span stays in use by the reader until cb_read_release(). It ends
+* at the physical end of the entries array, so a wrapped backlog takes
+* two peeks.
+*
+* @note Reader side only.
+*
+* @param cb     Pointer to the CircularBuffer instance.
+* @param reader Reader handle from cb_reader_register().
+* @param span   Receives a pointer to the reader's first unread entry.
+*
+* @return Number of entries in the span (0 if empty)
+*/
+uint32_t cb_read_peek(CircularBuffer *cb, cb_reader_t *reader, const struct sensor_reading **span)
+{
+    if (cb == NULL || reader == NULL || span == NULL) {
+        return 0U;
+    }
+
+    uint32_t tail      = (uint32_t)atomic_get(&reader->tail);
+    uint32_t available = cb_consumer_sync(cb, reader, &tail);
+    uint32_t idx       = tail & BUFFER_MASK;
+
+    *span = &cb->entries[idx];
+    return MIN(available, BUFFER_SIZE - idx);
+}
+
+/**
+* @brief Release entries obtained with cb_read_peek().
+*
+* In CB_OVERWRITE_OLDEST mode the producer may have overwritten the span
+* while it was being processed; the return value tells the reader to
+* discard whatever it derived from the span, and the span counts as
+* overrun.
+*
+* @note Reader side only.
+*
+* @param cb     Pointer to the CircularBuffer instance.
+* @param reader Reader handle from cb_reader_register().
+* @param count  Number of entries to release (at most the peeked count).
+*
+* @return true  if the released entries were intact while in use
+* @return false if they were overwritten or a NULL pointer was provided
+*/
+bool cb_read_release(CircularBuffer *cb, cb_reader_t *reader, uint32_t count)
+{
+    if (cb == NULL || reader == NULL) {
         return false;
     }
 
-    // Retrieve the oldest reading
-    (void)memcpy(output, &cb->entries[cb->tail], sizeof(struct sensor_reading));
+    uint32_t tail  = (uint32_t)atomic_get(&reader->tail);
+    bool     valid = cb_consumer_valid(cb, tail);
+    uint32_t used  = MIN(count, (uint32_t)atomic_get(&cb->head) - tail);
 
-    // Advance tail index
-    cb->tail = (cb->tail + 1U) % BUFFER_SIZE;
+    if (!valid) {
+        (void)atomic_add(&reader->overruns, (atomic_val_t)used);
+    }
+    (void)atomic_set(&reader->tail, (atomic_val_t)(tail + used));
 
-    return true;
+    return valid;
 }
 
+/**
+* @brief Wake every reader with at least min_lag unread entries.
+*
+* Gives the wake semaphore of each such reader. Called by the producer
+* after a sweep, and before it pauses at @ref BUFFER_HIGH_WATER.
+*
+* @param cb      Pointer to the CircularBuffer instance.
+* @param min_lag Unread entries a reader must have to be woken.
+*/
+void cb_notify_readers(CircularBuffer *cb, uint32_t min_lag)
+{
+    if (cb == NULL) {
+        return;
+    }
+
+    uint32_t n = (uint32_t)atomic_get(&cb->readers);
+
+    for (uint32_t r = 0U; r < n; r++) {
+        cb_reader_t *reader = &cb->reader[r];
+        if (reader->wake != NULL && cb_lag(cb, reader) >= min_lag) {
+            k_sem_give(reader->wake);
+        }
+    }
+}
+
+/**
+* @brief Number of entries waiting to be read by one reader.
+*
+* @param cb     Pointer to the CircularBuffer instance.
+* @param reader Reader handle from cb_reader_register().
+*
+* @return Unread entry count, clamped to BUFFER_SIZE
+*/
+uint32_t cb_lag(const CircularBuffer *cb, const cb_reader_t *reader)
+{
+    if (cb == NULL || reader == NULL) {
+        return 0U;
+    }
+
+    uint32_t used = (uint32_t)atomic_get(&cb->head) - (uint32_t)atomic_get(&reader->tail);
+    return (used > BUFFER_SIZE) ? BUFFER_SIZE : used;
+}
+
+/**
+* @brief Unread entries of the reader furthest behind.
+*
+* @param cb Pointer to the CircularBuffer instance.
+*
+* @return Largest lag of any registered reader (0 without readers)
+*/
+uint32_t cb_max_lag(const CircularBuffer *cb)
+{
+    if (cb == NULL) {
+        return 0U;
+    }
+
+    uint32_t n   = (uint32_t)atomic_get(&cb->readers);
+    uint32_t lag = 0U;
+
+    for (uint32_t r = 0U; r < n; r++) {
+        lag = MAX(lag, cb_lag(cb, &cb->reader[r]));
+    }
+
+    return lag;
+}
+
+/**
+* @brief Total number of entries one reader lost because the producer lapped it.
+*
+* @param reader Reader handle from cb_reader_register().
+*
+* @return Overrun entry count (CB_OVERWRITE_OLDEST only)
+*/
+uint32_t cb_overruns(const cb_reader_t *reader)
+{
+    if (reader == NULL) {
+        return 0U;
+    }
+
+    return (uint32_t)atomic_get(&reader->overruns);
+}
+
+/**
+* @brief Total number of entries the producer could not publish.
+*
+* Entries lost by a slow reader are counted per reader instead (cb_overruns()).
+*
+* @param cb Pointer to the CircularBuffer instance.
+*
+* @return Rejected (CB_DROP_NEWEST) or batch-discarded entry count
+*/
+uint32_t cb_dropped(const CircularBuffer *cb)
+{
+    if (cb == NULL) {
+        return 0U;
+    }
+
+    return (uint32_t)atomic_get(&cb->dropped);
+}
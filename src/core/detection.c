@@ -0,0 +1,224 @@
+/**
+* @file detection.c
+* @brief Batched range-check kernel for the detection stage.
+*
+* Evaluates value < min || value > max for a whole array of channels at
+* once and packs the result into a bitmask (bit i of word i / 32 is set
+* when channel i is out of range). The vector path is selected at compile
+* time from the target's feature macros; every path falls back to the
+* scalar loop for the tail, and all of them return identical masks.
+* NaN values never compare out of range, matching the scalar expression.
+*
+* With CONFIG_PM_FIXED_POINT the kernel compares Q16.16 integers instead.
+* Q16.16 conversion is monotonic, so for values and bounds on the Q16.16
+* grid it flags exactly the channels the float kernel flags.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+#include <arm_mve.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "detection.h"
+
+/**
+* @brief Scalar range check of channels [start, count).
+*
+* Bits of the mask for those channels must already be cleared.
+*
+* @return Number of channels flagged
+*/
+static uint32_t range_check_tail(const float *values, const float *min, const float *max,
+                                 uint32_t start, uint32_t count, uint32_t *mask)
+{
+    uint32_t flagged = 0U;
+
+    for (uint32_t i = start; i < count; i++) {
+        if (values[i] < min[i] || values[i] > max[i]) {
+            mask[i / 32U] |= (1U << (i % 32U));
+            flagged++;
+        }
+    }
+
+    return flagged;
+}
+
+/**
+* @brief Portable range-check kernel.
+*
+* Always available - used as the reference for the vector paths.
+*
+* @param values Array of channel values.
+* @param min    Array of lower bounds, one per channel.
+* @param max    Array of upper bounds, one per channel.
+* @param count  Number of channels.
+* @param mask   Output bitmask of DETECT_MASK_WORDS(count) words.
+*
+* @return Number of channels out of range
+*/
+uint32_t detect_out_of_range_scalar(const float *values, const float *min, const float *max,
+                                    uint32_t count, uint32_t *mask)
+{
+    if (values == NULL || min == NULL || max == NULL || mask == NULL) {
+        return 0U;
+    }
+
+    (void)memset(mask, 0, DETECT_MASK_WORDS(count) * sizeof(uint32_t));
+    return range_check_tail(values, min, max, 0U, count, mask);
+}
+
+/**
+* @brief Range-check kernel on Q16.16 values.
+*
+* Plain integer compares - no FPU needed, and simple enough for the
+* compiler to vectorize where the target has integer SIMD.
+*
+* @param values Array of channel values.
+* @param min    Array of lower bounds, one per channel.
+* @param max    Array of upper bounds, one per channel.
+* @param count  Number of channels.
+* @param mask   Output bitmask of DETECT_MASK_WORDS(count) words.
+*
+* @return Number of channels out of range
+*/
+uint32_t detect_out_of_range_q16(const q16_t *values, const q16_t *min, const q16_t *max,
+                                 uint32_t count, uint32_t *mask)
+{
+    if (values == NULL || min == NULL || max == NULL || mask == NULL) {
+        return 0U;
+    }
+
+    (void)memset(mask, 0, DETECT_MASK_WORDS(count) * sizeof(uint32_t));
+
+    uint32_t flagged = 0U;
+
+    for (uint32_t i = 0U; i < count; i++) {
+        uint32_t out = (uint32_t)((values[i] < min[i]) | (values[i] > max[i]));
+        mask[i / 32U] |= out << (i % 32U);
+        flagged += out;
+    }
+
+    return flagged;
+}
+
+#ifdef CONFIG_PM_FIXED_POINT
+
+/**
+* @brief Range-check kernel of the build - the Q16.16 integer kernel.
+*/
+uint32_t detect_out_of_range(const pm_value_t *values, const pm_value_t *min, const pm_value_t *max,
+                             uint32_t count, uint32_t *mask)
+{
+    return detect_out_of_range_q16(values, min, max, count, mask);
+}
+
+#else
+
+/**
+* @brief Range-check kernel using the widest vector unit of the target.
+*
+* @param values Array of channel values.
+* @param min    Array of lower bounds, one per channel.
+* @param max    Array of upper bounds, one per channel.
+* @param count  Number of channels.
+* @param mask   Output bitmask of DETECT_MASK_WORDS(count) words.
+*
+* @return Number of channels out of range
+*/
+uint32_t detect_out_of_range(const pm_value_t *values, const pm_value_t *min, const pm_value_t *max,
+                             uint32_t count, uint32_t *mask)
+{
+    if (values == NULL || min == NULL || max == NULL || mask == NULL) {
+        return 0U;
+    }
+
+    (void)memset(mask, 0, DETECT_MASK_WORDS(count) * sizeof(uint32_t));
+
+    uint32_t flagged = 0U;
+    uint32_t i = 0U;
+
+#if defined(__AVX__)
+    for (; i + 8U <= count; i += 8U) {
+        __m256 v   = _mm256_loadu_ps(&values[i]);
+        __m256 out = _mm256_or_ps(_mm256_cmp_ps(v, _mm256_loadu_ps(&min[i]), _CMP_LT_OQ),
+                                  _mm256_cmp_ps(v, _mm256_loadu_ps(&max[i]), _CMP_GT_OQ));
+        uint32_t bits = (uint32_t)_mm256_movemask_ps(out);
+
+        mask[i / 32U] |= bits << (i % 32U);
+        flagged += (uint32_t)__builtin_popcount(bits);
+    }
+#elif defined(__SSE2__)
+    for (; i + 4U <= count; i += 4U) {
+        __m128 v   = _mm_loadu_ps(&values[i]);
+        __m128 out = _mm_or_ps(_mm_cmplt_ps(v, _mm_loadu_ps(&min[i])),
+                               _mm_cmpgt_ps(v, _mm_loadu_ps(&max[i])));
+        uint32_t bits = (uint32_t)_mm_movemask_ps(out);
+
+        mask[i / 32U] |= bits << (i % 32U);
+        flagged += (uint32_t)__builtin_popcount(bits);
+    }
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+    for (; i + 4U <= count; i += 4U) {
+        float32x4_t v = vld1q_f32(&values[i]);
+        mve_pred16_t out = vcmpltq_f32(v, vld1q_f32(&min[i])) | vcmpgtq_f32(v, vld1q_f32(&max[i]));
+        // Predicates hold 4 bits per 32-bit lane - keep one bit per lane
+        uint32_t bits = ((out >> 0) & 1U) | ((out >> 3) & 2U) | ((out >> 6) & 4U) | ((out >> 9) & 8U);
+
+        mask[i / 32U] |= bits << (i % 32U);
+        flagged += (uint32_t)__builtin_popcount(bits);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint32_t lane_bit[4] = {1U, 2U, 4U, 8U};
+    const uint32x4_t weights = vld1q_u32(lane_bit);
+
+    for (; i + 4U <= count; i += 4U) {
+        float32x4_t v  = vld1q_f32(&values[i]);
+        uint32x4_t out = vorrq_u32(vcltq_f32(v, vld1q_f32(&min[i])), vcgtq_f32(v, vld1q_f32(&max[i])));
+        uint32_t bits  = vaddvq_u32(vandq_u32(out, weights));
+
+        mask[i / 32U] |= bits << (i % 32U);
+        flagged += (uint32_t)__builtin_popcount(bits);
+    }
+#endif
+
+    return flagged + range_check_tail(values, min, max, i, count, mask);
+}
+
+#endif  // CONFIG_PM_FIXED_POINT
+
+/**
+* @brief Vector path selected for this build.
+*/
+detect_impl_t detect_impl(void)
+{
+#if defined(CONFIG_PM_FIXED_POINT)
+    return DETECT_IMPL_Q16;
+#elif defined(__AVX__)
+    return DETECT_IMPL_AVX;
+#elif defined(__SSE2__)
+    return DETECT_IMPL_SSE2;
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+    return DETECT_IMPL_HELIUM;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    return DETECT_IMPL_NEON;
+#else
+    return DETECT_IMPL_SCALAR;
+#endif
+}
+
+/**
+* @brief Printable name of the vector path selected for this build.
+*/
+const char* detect_impl_name(void)
+{
+    static const char* const names[] = {"scalar", "sse2", "avx", "neon", "helium", "q16"};
+    return names[detect_impl()];
+}
@@ -0,0 +1,450 @@
+/**
+* @file history.c
+* @brief Compressed in-RAM sample history (Gorilla-style encoding).
+*
+* Encoding of every sample after the first of a block:
+*
+*   timestamp, dod = delta - previous delta:
+*     '0'                      dod == 0
+*     '10'   + 7 bits          dod in [-63, 64]
+*     '110'  + 9 bits          dod in [-255, 256]
+*     '1110' + 12 bits         dod in [-2047, 2048]
+*     '1111' + 32 bits         otherwise
+*
+*   value, x = bits ^ previous bits:
+*     '0'                      x == 0
+*     '10'   + meaningful bits x fits the previous leading/trailing-zero window
+*     '11'   + 5 bits leading zeros + 5 bits (length - 1) + length bits
+*
+* A sample costs at most 80 bits; a steady 1 Hz channel whose value did
+* not change costs 2. The value bits are those of a pm_value_t - a float,
+* or a Q16.16 integer with CONFIG_PM_FIXED_POINT; the XOR scheme works
+* the same on both.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/barrier.h>
+
+#include "history.h"
+
+/** @brief Largest encoding of one sample in bits */
+#define HISTORY_MAX_SAMPLE_BITS     80U
+
+/** @brief No XOR window established yet */
+#define HISTORY_NO_WINDOW           0xFFU
+
+BUILD_ASSERT(HISTORY_BLOCKS >= 2U, "history needs a block to recycle while one is live");
+BUILD_ASSERT(HISTORY_BLOCK_BYTES * 8U >= HISTORY_MAX_SAMPLE_BITS, "block must hold one encoded sample");
+BUILD_ASSERT(HISTORY_BLOCK_BYTES * 8U <= UINT16_MAX, "bit positions are 16-bit");
+BUILD_ASSERT(sizeof(pm_value_t) == sizeof(uint32_t), "values are encoded as 32-bit patterns");
+
+static uint32_t value_bits(pm_value_t v)
+{
+    uint32_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+static pm_value_t bits_value(uint32_t b)
+{
+    pm_value_t v;
+    memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+/**
+* @brief Append n (<= 32) bits, MSB first. The target bytes must be zero.
+*/
+static void put_bits(uint8_t *data, uint32_t pos, uint32_t value, uint32_t n)
+{
+    while (n > 0U) {
+        uint32_t room = 8U - (pos & 7U);
+        uint32_t take = MIN(room, n);
+        uint32_t chunk = (value >> (n - take)) & ((1U << take) - 1U);
+
+        data[pos >> 3] |= (uint8_t)(chunk << (room - take));
+        pos += take;
+        n   -= take;
+    }
+}
+
+/**
+* @brief Read n (<= 32) bits, MSB first.
+*/
+static uint32_t get_bits(const uint8_t *data, uint32_t pos, uint32_t n)
+{
+    uint32_t value = 0U;
+
+    while (n > 0U) {
+        uint32_t room = 8U - (pos & 7U);
+        uint32_t take = MIN(room, n);
+        uint32_t chunk = ((uint32_t)data[pos >> 3] >> (room - take)) & ((1U << take) - 1U);
+
+        value = (value << take) | chunk;
+        pos += take;
+        n   -= take;
+    }
+    return value;
+}
+
+/**
+* @brief Encoded size of a timestamp delta-of-delta.
+*/
+static uint32_t dod_bits(int32_t dod)
+{
+    if (dod == 0) {
+        return 1U;
+    }
+    if (dod >= -63 && dod <= 64) {
+        return 2U + 7U;
+    }
+    if (dod >= -255 && dod <= 256) {
+        return 3U + 9U;
+    }
+    if (dod >= -2047 && dod <= 2048) {
+        return 4U + 12U;
+    }
+    return 4U + 32U;
+}
+
+static uint32_t put_dod(uint8_t *data, uint32_t pos, int32_t dod)
+{
+    if (dod == 0) {
+        put_bits(data, pos, 0x0U, 1U);
+        return 1U;
+    }
+    if (dod >= -63 && dod <= 64) {
+        put_bits(data, pos, 0x2U, 2U);
+        put_bits(data, pos + 2U, (uint32_t)(dod + 63), 7U);
+        return 9U;
+    }
+    if (dod >= -255 && dod <= 256) {
+        put_bits(data, pos, 0x6U, 3U);
+        put_bits(data, pos + 3U, (uint32_t)(dod + 255), 9U);
+        return 12U;
+    }
+    if (dod >= -2047 && dod <= 2048) {
+        put_bits(data, pos, 0xEU, 4U);
+        put_bits(data, pos + 4U, (uint32_t)(dod + 2047), 12U);
+        return 16U;
+    }
+    put_bits(data, pos, 0xFU, 4U);
+    put_bits(data, pos + 4U, (uint32_t)dod, 32U);
+    return 36U;
+}
+
+static int32_t get_dod(const uint8_t *data, uint16_t *pos)
+{
+    uint32_t p = *pos;
+    int32_t dod;
+
+    if (get_bits(data, p, 1U) == 0U) {
+        dod = 0;
+        p += 1U;
+    } else if (get_bits(data, p + 1U, 1U) == 0U) {
+        dod = (int32_t)get_bits(data, p + 2U, 7U) - 63;
+        p += 9U;
+    } else if (get_bits(data, p + 2U, 1U) == 0U) {
+        dod = (int32_t)get_bits(data, p + 3U, 9U) - 255;
+        p += 12U;
+    } else if (get_bits(data, p + 3U, 1U) == 0U) {
+        dod = (int32_t)get_bits(data, p + 4U, 12U) - 2047;
+        p += 16U;
+    } else {
+        dod = (int32_t)get_bits(data, p + 4U, 32U);
+        p += 36U;
+    }
+    *pos = (uint16_t)p;
+    return dod;
+}
+
+/**
+* @brief true if a non-zero XOR fits the current leading/trailing-zero window.
+*/
+static bool xor_in_window(uint32_t x, uint8_t leading, uint8_t trailing)
+{
+    return leading != HISTORY_NO_WINDOW &&
+           (uint32_t)__builtin_clz(x) >= leading &&
+           (uint32_t)__builtin_ctz(x) >= trailing;
+}
+
+/**
+* @brief Encoded size of a value XOR.
+*/
+static uint32_t xor_bits(uint32_t x, uint8_t leading, uint8_t trailing)
+{
+    if (x == 0U) {
+        return 1U;
+    }
+    if (xor_in_window(x, leading, trailing)) {
+        return 2U + (32U - leading - trailing);
+    }
+    uint32_t lz = MIN((uint32_t)__builtin_clz(x), 31U);
+    return 2U + 5U + 5U + (32U - lz - (uint32_t)__builtin_ctz(x));
+}
+
+static void open_block(history_t *h, uint32_t t, uint32_t v)
+{
+    uint32_t serial = (uint32_t)atomic_get(&h->next);
+
+    // Ring full - retire the oldest block before overwriting it
+    if (serial - (uint32_t)atomic_get(&h->first) >= HISTORY_BLOCKS) {
+        (void)atomic_inc(&h->first);
+    }
+
+    history_block_t *b = &h->block[serial % HISTORY_BLOCKS];
+
+    // New serial first, so readers still decoding the old block notice
+    (void)atomic_set(&b->serial, (atomic_val_t)serial);
+    barrier_dmem_fence_full();
+
+    memset(b->data, 0, sizeof(b->data));
+    b->t_first_ms = t;
+    b->t_last_ms  = t;
+    b->v_first    = v;
+    b->bits       = 0U;
+    b->count      = 1U;
+
+    h->prev_t     = t;
+    h->prev_delta = 0;
+    h->prev_v     = v;
+    h->leading    = HISTORY_NO_WINDOW;
+    h->trailing   = 0U;
+
+    barrier_dmem_fence_full();
+    (void)atomic_set(&h->next, (atomic_val_t)(serial + 1U));
+}
+
+/**
+* @brief Reset a history to empty.
+*/
+void history_init(history_t *h)
+{
+    if (h == NULL) {
+        return;
+    }
+    memset(h, 0, sizeof(*h));
+    h->leading = HISTORY_NO_WINDOW;
+}
+
+/**
+* @brief Append one sample.
+*
+* Timestamps must not decrease. O(1); opens a new block (recycling the
+* oldest one if needed) when the sample does not fit the current block.
+*/
+void history_append(history_t *h, uint32_t timestamp_ms, pm_value_t value)
+{
+    if (h == NULL) {
+        return;
+    }
+
+    uint32_t v = value_bits(value);
+
+    if ((uint32_t)atomic_get(&h->next) == (uint32_t)atomic_get(&h->first)) {
+        open_block(h, timestamp_ms, v);
+        return;
+    }
+
+    history_block_t *b = &h->block[((uint32_t)atomic_get(&h->next) - 1U) % HISTORY_BLOCKS];
+    int32_t  delta = (int32_t)(timestamp_ms - h->prev_t);
+    int32_t  dod   = delta - h->prev_delta;
+    uint32_t x     = v ^ h->prev_v;
+
+    if ((uint32_t)b->bits + dod_bits(dod) + xor_bits(x, h->leading, h->trailing) > HISTORY_BLOCK_BYTES * 8U ||
+        b->count == UINT16_MAX) {
+        open_block(h, timestamp_ms, v);
+        return;
+    }
+
+    uint32_t pos = b->bits;
+    pos += put_dod(b->data, pos, dod);
+
+    if (x == 0U) {
+        put_bits(b->data, pos, 0x0U, 1U);
+        pos += 1U;
+    } else if (xor_in_window(x, h->leading, h->trailing)) {
+        uint32_t len = 32U - h->leading - h->trailing;
+        put_bits(b->data, pos, 0x2U, 2U);
+        put_bits(b->data, pos + 2U, x >> h->trailing, len);
+        pos += 2U + len;
+    } else {
+        uint32_t lz  = MIN((uint32_t)__builtin_clz(x), 31U);
+        uint32_t tz  = (uint32_t)__builtin_ctz(x);
+        uint32_t len = 32U - lz - tz;
+        put_bits(b->data, pos, 0x3U, 2U);
+        put_bits(b->data, pos + 2U, lz, 5U);
+        put_bits(b->data, pos + 7U, len - 1U, 5U);
+        put_bits(b->data, pos + 12U, x >> tz, len);
+        pos += 12U + len;
+        h->leading  = (uint8_t)lz;
+        h->trailing = (uint8_t)tz;
+    }
+
+    h->prev_t     = timestamp_ms;
+    h->prev_delta = delta;
+    h->prev_v     = v;
+
+    b->bits      = (uint16_t)pos;
+    b->t_last_ms = timestamp_ms;
+
+    // Publish the sample after its bits
+    barrier_dmem_fence_full();
+    b->count++;
+}
+
+/**
+* @brief true if t lies in [from_ms, to_ms] - wrap-safe, and [0, UINT32_MAX] covers everything.
+*/
+static bool in_range(const history_iter_t *it, uint32_t t)
+{
+    return (t - it->from_ms) <= (it->to_ms - it->from_ms);
+}
+
+/**
+* @brief Start iterating the samples with from_ms <= timestamp <= to_ms.
+*
+* Nothing is decoded here; blocks that end before from_ms are skipped
+* by their header alone.
+*/
+void history_iter_init(history_iter_t *it, const history_t *h, uint32_t from_ms, uint32_t to_ms)
+{
+    if (it == NULL) {
+        return;
+    }
+    memset(it, 0, sizeof(*it));
+    it->h       = h;
+    it->from_ms = from_ms;
+    it->to_ms   = to_ms;
+
+    if (h == NULL) {
+        return;
+    }
+
+    uint32_t next = (uint32_t)atomic_get(&h->next);
+    it->serial = (uint32_t)atomic_get(&h->first);
+
+    // Skip whole blocks that end before the range (the newest block is always decoded)
+    while ((next - it->serial) > 1U) {
+        uint32_t t_last = h->block[it->serial % HISTORY_BLOCKS].t_last_ms;
+        if (in_range(it, t_last) || (int32_t)(t_last - from_ms) >= 0) {
+            break;
+        }
+        it->serial++;
+    }
+}
+
+/**
+* @brief Decode the next sample of the range.
+*
+* @return false at the end of the range, or at the end of the history
+*         (a later call returns samples appended since)
+*/
+bool history_iter_next(history_iter_t *it, uint32_t *timestamp_ms, pm_value_t *value)
+{
+    if (it == NULL || it->h == NULL || timestamp_ms == NULL || value == NULL) {
+        return false;
+    }
+    const history_t *h = it->h;
+
+    while (1) {
+        uint32_t first = (uint32_t)atomic_get(&h->first);
+        uint32_t next  = (uint32_t)atomic_get(&h->next);
+
+        if ((int32_t)(it->serial - first) < 0) {
+            it->serial = first;                 // Overtaken by the writer - skip the lost blocks
+            it->loaded = false;
+        }
+        if (it->serial == next) {
+            return false;
+        }
+
+        const history_block_t *b = &h->block[it->serial % HISTORY_BLOCKS];
+
+        if (!it->loaded) {
+            it->index   = 0U;
+            it->count   = 0U;
+            it->pos     = 0U;
+            it->t       = b->t_first_ms;
+            it->delta   = 0;
+            it->v       = b->v_first;
+            it->leading = HISTORY_NO_WINDOW;
+            it->loaded  = true;
+        }
+
+        if (it->index >= it->count) {
+            it->count = b->count;
+            barrier_dmem_fence_full();
+            if (it->index >= it->count) {
+                if (it->serial + 1U == next) {
+                    return false;               // Caught up with the writer
+                }
+                it->serial++;
+                it->loaded = false;
+                continue;
+            }
+        }
+
+        if (it->index > 0U) {
+            it->delta += get_dod(b->data, &it->pos);
+            it->t     += (uint32_t)it->delta;
+
+            if (get_bits(b->data, it->pos, 1U) == 0U) {
+                it->pos += 1U;
+            } else if (get_bits(b->data, it->pos + 1U, 1U) == 0U) {
+                uint32_t len = 32U - it->leading - it->trailing;
+                it->v ^= get_bits(b->data, it->pos + 2U, len) << it->trailing;
+                it->pos += (uint16_t)(2U + len);
+            } else {
+                uint32_t lz  = get_bits(b->data, it->pos + 2U, 5U);
+                uint32_t len = get_bits(b->data, it->pos + 7U, 5U) + 1U;
+                uint32_t tz  = 32U - lz - len;
+                it->v ^= get_bits(b->data, it->pos + 12U, len) << tz;
+                it->pos += (uint16_t)(12U + len);
+                it->leading  = (uint8_t)lz;
+                it->trailing = (uint8_t)tz;
+            }
+        }
+        it->index++;
+
+        // Block recycled while decoding - what was read is garbage
+        barrier_dmem_fence_full();
+        if ((uint32_t)atomic_get(&b->serial) != it->serial) {
+            it->loaded = false;
+            continue;
+        }
+
+        if (!in_range(it, it->t)) {
+            if ((int32_t)(it->t - it->from_ms) < 0) {
+                continue;                       // Before the range
+            }
+            return false;
+        }
+        *timestamp_ms = it->t;
+        *value        = bits_value(it->v);
+        return true;
+    }
+}
+
+/**
+* @brief Count the samples held and the bytes they occupy.
+*/
+void history_usage(const history_t *h, history_usage_t *out)
+{
+    if (h == NULL || out == NULL) {
+        return;
+    }
+    out->samples = 0U;
+    out->bytes   = 0U;
+
+    uint32_t next = (uint32_t)atomic_get(&h->next);
+    for (uint32_t s = (uint32_t)atomic_get(&h->first); s != next; s++) {
+        const history_block_t *b = &h->block[s % HISTORY_BLOCKS];
+        out->samples += b->count;
+        out->bytes   += (uint32_t)offsetof(history_block_t, data) + (((uint32_t)b->bits + 7U) / 8U);
+    }
+}
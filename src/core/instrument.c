@@ -0,0 +1,149 @@
+/**
+* @file instrument.c
+* @brief Stage latency histograms and thread CPU accounting.
+*
+* Recording costs one bucket increment plus, for a new maximum, a short
+* compare-and-swap loop (see latency.c).
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/kernel.h>
+
+#include "instrument.h"
+#include "shared_resources.h"
+
+/**
+* @brief CPU accounting state of one registered thread.
+*/
+typedef struct {
+    struct k_thread *thread;
+    const char      *name;
+    uint64_t         last_cycles;       /**< Thread execution cycles at the previous dump */
+} instr_thread_t;
+
+static latency_hist_t hist[INSTR_STAGE_COUNT];
+
+static instr_thread_t threads[INSTR_MAX_THREADS];
+static uint32_t thread_count;
+static uint64_t last_total_cycles;      /**< Execution cycles of all threads at the previous dump */
+
+static const char* const stage_names[INSTR_STAGE_COUNT] = {
+    "write",
+    "collect",
+    "enqueue",
+    "detect",
+    "handle"
+};
+
+/**
+* @brief Record one duration under a stage.
+*
+* Safe to call from any thread concurrently.
+*
+* @param stage Stage the duration belongs to.
+* @param us    Duration in microseconds.
+*/
+void instr_record(instr_stage_t stage, uint32_t us)
+{
+    if ((unsigned int)stage >= INSTR_STAGE_COUNT) {
+        return;
+    }
+    latency_record(&hist[stage], us);
+}
+
+/**
+* @brief Summarize a stage's histogram (see latency_summary()).
+*
+* @return false on an invalid stage or NULL output
+*/
+bool instr_summary(instr_stage_t stage, latency_summary_t *out)
+{
+    if ((unsigned int)stage >= INSTR_STAGE_COUNT) {
+        return false;
+    }
+    return latency_summary(&hist[stage], out);
+}
+
+const char* instr_stage_name(instr_stage_t stage)
+{
+    if ((unsigned int)stage >= INSTR_STAGE_COUNT) {
+        return "unknown";
+    }
+    return stage_names[stage];
+}
+
+/**
+* @brief Add a thread to CPU accounting.
+*
+* Call once per thread during initialization, before instr_dump() runs.
+*
+* @return false if the thread table is full or an argument is NULL
+*/
+bool instr_register_thread(struct k_thread *thread, const char *name)
+{
+    if (thread == NULL || name == NULL || thread_count >= INSTR_MAX_THREADS) {
+        return false;
+    }
+    threads[thread_count].thread      = thread;
+    threads[thread_count].name        = name;
+    threads[thread_count].last_cycles = 0U;
+    thread_count++;
+    return true;
+}
+
+const char* instr_thread_name(uint32_t index)
+{
+    if (index >= thread_count) {
+        return "unknown";
+    }
+    return threads[index].name;
+}
+
+/**
+* @brief Post a compact statistics report to the system logger.
+*
+* One record per stage (count, p50, p99, max) and, with thread runtime
+* stats available, one record per registered thread with its share of
+* CPU time since the previous dump, in permille.
+*/
+void instr_dump(void)
+{
+    for (uint32_t s = 0U; s < INSTR_STAGE_COUNT; s++) {
+        latency_summary_t sum;
+        (void)instr_summary((instr_stage_t)s, &sum);
+
+        log_msg_t msg = {
+            .fmt = LOG_FMT_STAGE_STATS, .thread_id = 0, .slot = (uint16_t)s,
+            .args = {{.u = sum.count}, {.u = sum.p50_us}, {.u = sum.p99_us}, {.u = sum.max_us}}
+        };
+        log_post(&msg);
+    }
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+    k_thread_runtime_stats_t all;
+    if (k_thread_runtime_stats_all_get(&all) != 0) {
+        return;
+    }
+    uint64_t total = all.execution_cycles - last_total_cycles;
+    last_total_cycles = all.execution_cycles;
+
+    for (uint32_t i = 0U; i < thread_count; i++) {
+        k_thread_runtime_stats_t rt;
+        if (k_thread_runtime_stats_get(threads[i].thread, &rt) != 0) {
+            continue;
+        }
+        uint64_t used = rt.execution_cycles - threads[i].last_cycles;
+        threads[i].last_cycles = rt.execution_cycles;
+
+        log_msg_t msg = {
+            .fmt = LOG_FMT_THREAD_CPU, .thread_id = 0, .slot = (uint16_t)i,
+            .args = {{.u = (total > 0U) ? (uint32_t)((used * 1000U) / total) : 0U}}
+        };
+        log_post(&msg);
+    }
+#else
+    (void)last_total_cycles;
+#endif
+}
@@ -0,0 +1,108 @@
+/**
+* @file latency.c
+* @brief Lock-free fixed-bucket latency histograms.
+*
+* Summaries are computed on demand from the bucket counts; a snapshot
+* taken while other threads record may be off by the samples recorded
+* during the read, which is fine for monitoring.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/sys/util.h>
+
+#include "latency.h"
+
+/**
+* @brief Bucket of a duration: 0 for 0 us, else 1 + floor(log2(us)), clamped.
+*/
+static uint32_t bucket_of(uint32_t us)
+{
+    if (us == 0U) {
+        return 0U;
+    }
+    uint32_t b = 32U - (uint32_t)__builtin_clz(us);
+    return (b < LATENCY_BUCKETS) ? b : (LATENCY_BUCKETS - 1U);
+}
+
+/**
+* @brief Upper edge of a bucket in microseconds.
+*/
+static uint32_t bucket_upper_us(uint32_t b)
+{
+    return (b == 0U) ? 0U : ((1U << b) - 1U);
+}
+
+/**
+* @brief Record one duration.
+*
+* Safe to call from any thread concurrently.
+*
+* @param h  Pointer to the histogram.
+* @param us Duration in microseconds.
+*/
+void latency_record(latency_hist_t *h, uint32_t us)
+{
+    if (h == NULL) {
+        return;
+    }
+
+    (void)atomic_inc(&h->bucket[bucket_of(us)]);
+
+    atomic_val_t max = atomic_get(&h->max_us);
+    while ((uint32_t)max < us) {
+        if (atomic_cas(&h->max_us, max, (atomic_val_t)us)) {
+            break;
+        }
+        max = atomic_get(&h->max_us);
+    }
+}
+
+/**
+* @brief Summarize a histogram.
+*
+* Percentiles are reported as the upper edge of the bucket that contains
+* them (capped at the maximum), so they overestimate by less than 2x.
+*
+* @param h   Pointer to the histogram.
+* @param out Destination summary.
+*
+* @return false on a NULL argument
+*/
+bool latency_summary(const latency_hist_t *h, latency_summary_t *out)
+{
+    if (h == NULL || out == NULL) {
+        return false;
+    }
+    uint32_t counts[LATENCY_BUCKETS];
+    uint32_t total = 0U;
+
+    for (uint32_t b = 0U; b < LATENCY_BUCKETS; b++) {
+        counts[b] = (uint32_t)atomic_get(&h->bucket[b]);
+        total += counts[b];
+    }
+
+    out->count  = total;
+    out->p50_us = 0U;
+    out->p99_us = 0U;
+    out->max_us = (uint32_t)atomic_get(&h->max_us);
+
+    // Ranks of the percentiles, rounded up (1-based)
+    uint32_t rank50 = (total + 1U) / 2U;
+    uint32_t rank99 = (uint32_t)(((uint64_t)total * 99U + 99U) / 100U);
+    uint32_t seen = 0U;
+
+    for (uint32_t b = 0U; b < LATENCY_BUCKETS && total > 0U; b++) {
+        uint32_t before = seen;
+        seen += counts[b];
+        if (before < rank50 && seen >= rank50) {
+            out->p50_us = MIN(bucket_upper_us(b), out->max_us);
+        }
+        if (before < rank99 && seen >= rank99) {
+            out->p99_us = MIN(bucket_upper_us(b), out->max_us);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,199 @@
+/**
+* @file rollup.c
+* @brief Per-sensor tumbling-window rollups at 1 s, 1 min and 1 h.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "rollup.h"
+
+/** @brief Window length of each level */
+static const uint32_t window_ms[ROLLUP_LEVELS] = { 1000U, 60000U, 3600000U };
+
+static const char* const level_names[ROLLUP_LEVELS] = { "1s", "1min", "1h" };
+
+static uint32_t window_start(rollup_level_t level, uint32_t t_ms)
+{
+    return t_ms - (t_ms % window_ms[level]);
+}
+
+/**
+* @brief Fold a partial aggregate (one sample, or a closed lower window) into a level.
+*/
+static void acc_merge(rollup_acc_t *acc, uint32_t start_ms, const rollup_acc_t *in)
+{
+    if (acc->count == 0U) {
+        *acc = *in;
+        acc->start_ms = start_ms;
+        return;
+    }
+    acc->count += in->count;
+    acc->sum   += in->sum;
+    acc->last   = in->last;
+    if (in->min < acc->min) {
+        acc->min = in->min;
+    }
+    if (in->max > acc->max) {
+        acc->max = in->max;
+    }
+}
+
+static void acc_close(const rollup_acc_t *acc, rollup_level_t level, rollup_record_t *out)
+{
+    out->start_ms = acc->start_ms;
+    out->count    = acc->count;
+    out->min      = acc->min;
+    out->max      = acc->max;
+#ifdef CONFIG_PM_FIXED_POINT
+    out->mean     = q16_div_int(acc->sum, acc->count);
+#else
+    out->mean     = acc->sum / (float)acc->count;
+#endif
+    out->last     = acc->last;
+    out->level    = (uint8_t)level;
+}
+
+/**
+* @brief Fold an aggregate at t_ms into a level (in may be NULL), closing
+*        the window in progress first if t_ms lies outside it.
+*
+* A closed window cascades into the next level.
+*
+* @return Number of records written to out
+*/
+static uint32_t level_push(sensor_rollup_t *r, rollup_level_t level, uint32_t t_ms,
+                           const rollup_acc_t *in, rollup_record_t *out)
+{
+    rollup_acc_t *acc = &r->level[level];
+    uint32_t start = window_start(level, t_ms);
+    uint32_t n = 0U;
+
+    if (acc->count > 0U && start != acc->start_ms) {
+        acc_close(acc, level, &out[n++]);
+        if (level == ROLLUP_1S) {
+            r->closed_ms = acc->start_ms + window_ms[ROLLUP_1S];
+        }
+        if (level + 1U < ROLLUP_LEVELS) {
+            n += level_push(r, (rollup_level_t)(level + 1U), acc->start_ms, acc, &out[n]);
+        }
+        acc->count = 0U;
+    }
+    if (in != NULL) {
+        acc_merge(acc, start, in);
+    }
+    return n;
+}
+
+/**
+* @brief Close the window in progress of every level that t_ms lies outside of.
+*
+* Bottom-up, so a closing window is merged into the level above before
+* that level is checked - the 1 min window that ends with a second is
+* emitted together with that second.
+*/
+static uint32_t close_before(sensor_rollup_t *r, uint32_t t_ms, rollup_record_t *out)
+{
+    uint32_t n = 0U;
+
+    for (uint32_t level = 0U; level < ROLLUP_LEVELS; level++) {
+        n += level_push(r, (rollup_level_t)level, t_ms, NULL, &out[n]);
+    }
+    return n;
+}
+
+/**
+* @brief Close the window in progress of every level that ended at or before t_ms.
+*
+* Unlike close_before(), t_ms may lie before the newest sample: a window
+* that has not ended yet is left open.
+*/
+static uint32_t close_ended(sensor_rollup_t *r, uint32_t t_ms, rollup_record_t *out)
+{
+    uint32_t n = 0U;
+
+    for (uint32_t level = 0U; level < ROLLUP_LEVELS; level++) {
+        const rollup_acc_t *acc = &r->level[level];
+        if (acc->count > 0U && (int32_t)(t_ms - (acc->start_ms + window_ms[level])) >= 0) {
+            n += level_push(r, (rollup_level_t)level, t_ms, NULL, &out[n]);
+        }
+    }
+    return n;
+}
+
+/**
+* @brief Reset all levels to empty.
+*/
+void rollup_init(sensor_rollup_t *r)
+{
+    if (r == NULL) {
+        return;
+    }
+    memset(r, 0, sizeof(*r));
+}
+
+/**
+* @brief Add one sample.
+*
+* Timestamps must not decrease. O(1); only when the sample starts a new
+* window does the closed window cascade upwards. A sample whose 1 s
+* window was already closed (by rollup_expire) is dropped and counted in
+* r->late.
+*
+* @param out Receives the windows closed by this sample, shortest level first.
+*
+* @return Number of records written to out
+*/
+uint32_t rollup_push(sensor_rollup_t *r, uint32_t timestamp_ms, pm_value_t value,
+                     rollup_record_t out[ROLLUP_MAX_CLOSED])
+{
+    if (r == NULL || out == NULL) {
+        return 0U;
+    }
+    if (r->closed_ms != 0U && (int32_t)(timestamp_ms - r->closed_ms) < 0) {
+        r->late++;
+        return 0U;
+    }
+    rollup_acc_t sample = {
+        .start_ms = timestamp_ms, .count = 1U,
+        .min = value, .max = value, .sum = value, .last = value
+    };
+    uint32_t n = close_before(r, timestamp_ms, out);
+    return n + level_push(r, ROLLUP_1S, timestamp_ms, &sample, &out[n]);
+}
+
+/**
+* @brief Close every window that ended at or before now_ms.
+*
+* Lets a sensor that stopped reporting still emit its last windows.
+* Callers should pass their clock minus a grace period covering the
+* pipeline latency, so readings still in flight reach their window before
+* it closes; now_ms may lie before the newest sample.
+*
+* @return Number of records written to out
+*/
+uint32_t rollup_expire(sensor_rollup_t *r, uint32_t now_ms, rollup_record_t out[ROLLUP_MAX_CLOSED])
+{
+    if (r == NULL || out == NULL) {
+        return 0U;
+    }
+    return close_ended(r, now_ms, out);
+}
+
+uint32_t rollup_window_ms(rollup_level_t level)
+{
+    if ((unsigned int)level >= ROLLUP_LEVELS) {
+        return 0U;
+    }
+    return window_ms[level];
+}
+
+const char* rollup_level_name(rollup_level_t level)
+{
+    if ((unsigned int)level >= ROLLUP_LEVELS) {
+        return "unknown";
+    }
+    return level_names[level];
+}
@@ -0,0 +1,226 @@
+/**
+* @file scheduler.c
+* @brief Hierarchical timer wheel for per-sensor sampling.
+*
+* Each sensor is an entry with its own period and absolute deadline. The
+* acquisition thread advances the wheel tick by tick and gets back only
+* the entries that are due; each is immediately rescheduled at
+* deadline + period so rates do not drift with processing jitter.
+* Tick counters are free-running and compared wrap-safely.
+*
+* Entries are kept in a hierarchical wheel: a deadline less than one
+* revolution ahead sits in the level-0 bucket of its tick, one further
+* away in a coarser bucket of a higher level, and is moved down when the
+* wheel reaches that bucket. A tick thus only visits due entries; an
+* entry is moved at most SCHED_WHEEL_LEVELS - 1 times per period.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/util.h>
+
+#include "scheduler.h"
+
+/** @brief Bucket index mask of a level. */
+#define SCHED_SLOT_MASK     (SCHED_WHEEL_SLOTS - 1U)
+
+/** @brief Ticks spanned by one bucket of a level. */
+#define SCHED_LEVEL_SPAN(l) (1U << (SCHED_WHEEL_BITS * (l)))
+
+BUILD_ASSERT(SCHED_WHEEL_BITS * SCHED_WHEEL_LEVELS < 32U, "Timer wheel levels exceed the tick counter");
+
+/** @brief Wrap-safe "a is at or before b" for free-running tick counters. */
+static inline bool tick_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(b - a) >= 0;
+}
+
+/**
+* @brief Link an entry into the bucket that holds its deadline.
+*
+* The entry goes to the lowest level whose revolution still reaches the
+* deadline; a deadline beyond the top level is parked in the top-level
+* bucket visited last and placed again when that bucket is reached.
+* The deadline must lie at or after now.
+*/
+static void sched_link(sched_wheel_t *w, uint16_t id)
+{
+    uint32_t deadline = w->entry[id].deadline;
+    uint32_t delta    = deadline - w->now;
+    uint32_t level    = 0U;
+
+    while (level < SCHED_WHEEL_LEVELS - 1U && delta >= SCHED_LEVEL_SPAN(level + 1U)) {
+        level++;
+    }
+
+    uint32_t shift = SCHED_WHEEL_BITS * level;
+    uint32_t b = (deadline >> shift) & SCHED_SLOT_MASK;
+    if (delta >= SCHED_LEVEL_SPAN(SCHED_WHEEL_LEVELS)) {
+        b = ((w->now >> shift) - 1U) & SCHED_SLOT_MASK;
+    }
+
+    w->entry[id].next = w->bucket[level][b];
+    w->bucket[level][b] = id;
+}
+
+/**
+* @brief Move the entries of a higher-level bucket down to the levels matching their deadlines.
+*/
+static void sched_cascade(sched_wheel_t *w, uint32_t level, uint32_t b)
+{
+    uint16_t id = w->bucket[level][b];
+    w->bucket[level][b] = SCHED_NONE;
+
+    while (id != SCHED_NONE) {
+        uint16_t next = w->entry[id].next;
+        sched_link(w, id);
+        id = next;
+    }
+}
+
+/**
+* @brief Whether a higher-level bucket holding entries is moved down on tick t.
+*/
+static bool sched_cascades_at(const sched_wheel_t *w, uint32_t t)
+{
+    for (uint32_t level = 1U; level < SCHED_WHEEL_LEVELS; level++) {
+        if ((t & (SCHED_LEVEL_SPAN(level) - 1U)) != 0U) {
+            break;
+        }
+        if (w->bucket[level][(t >> (SCHED_WHEEL_BITS * level)) & SCHED_SLOT_MASK] != SCHED_NONE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+* @brief Empty the wheel.
+*
+* @param w   Pointer to the wheel.
+* @param now Current tick - the first sched_tick() processes now + 1.
+*/
+void sched_init(sched_wheel_t *w, uint32_t now)
+{
+    if (w == NULL) {
+        return;
+    }
+
+    for (uint32_t level = 0U; level < SCHED_WHEEL_LEVELS; level++) {
+        for (uint32_t b = 0U; b < SCHED_WHEEL_SLOTS; b++) {
+            w->bucket[level][b] = SCHED_NONE;
+        }
+    }
+    for (uint32_t i = 0U; i < SCHED_MAX_ENTRIES; i++) {
+        w->entry[i].active = false;
+    }
+    w->now = now;
+}
+/**
+* @brief Schedule a periodic entry.
+*
+* @param w              Pointer to the wheel.
+* @param id             Entry ID (e.g. sensor bank slot).
+* @param period         Ticks between runs (at least 1).
+* @param first_deadline Absolute tick of the first run - clamped to the next tick if already past.
+*
+* @return true  if the entry was scheduled
+* @return false if the ID is out of range, already scheduled or the period is 0
+*/
+bool sched_add(sched_wheel_t *w, uint16_t id, uint32_t period, uint32_t first_deadline)
+{
+    if (w == NULL || id >= SCHED_MAX_ENTRIES || period == 0U || w->entry[id].active) {
+        return false;
+    }
+
+    if (tick_reached(first_deadline, w->now)) {
+        first_deadline = w->now + 1U;
+    }
+
+    w->entry[id].deadline = first_deadline;
+    w->entry[id].period   = period;
+    w->entry[id].active   = true;
+    sched_link(w, id);
+
+    return true;
+}
+
+/**
+* @brief Advance the wheel by one tick and collect the entries due on it.
+*
+* Due entries are rescheduled one period later before returning.
+*
+* @param w       Pointer to the wheel.
+* @param due     Receives the IDs of the due entries.
+* @param max_due Capacity of due; entries beyond it are deferred to the next tick.
+*
+* @return Number of IDs written to due
+*/
+uint32_t sched_tick(sched_wheel_t *w, uint16_t *due, uint32_t max_due)
+{
+    if (w == NULL || due == NULL) {
+        return 0U;
+    }
+
+    w->now++;
+
+    // Move the next bucket of every level whose revolution ends here down, coarsest first
+    for (uint32_t level = SCHED_WHEEL_LEVELS - 1U; level > 0U; level--) {
+        if ((w->now & (SCHED_LEVEL_SPAN(level) - 1U)) == 0U) {
+            sched_cascade(w, level, (w->now >> (SCHED_WHEEL_BITS * level)) & SCHED_SLOT_MASK);
+        }
+    }
+
+    // Detach the bucket of this tick - everything in it is due now
+    uint32_t b  = w->now & SCHED_SLOT_MASK;
+    uint16_t id = w->bucket[0][b];
+    w->bucket[0][b] = SCHED_NONE;
+
+    uint32_t count = 0U;
+
+    while (id != SCHED_NONE) {
+        sched_entry_t *e = &w->entry[id];
+        uint16_t next = e->next;
+
+        if (e->deadline == w->now && count < max_due) {
+            due[count++] = id;
+            e->deadline += e->period;
+        } else if (e->deadline == w->now) {
+            e->deadline++;          // Out of room - run on the next tick
+        }
+
+        // Rescheduled - link into the bucket of its new deadline
+        sched_link(w, id);
+        id = next;
+    }
+
+    return count;
+}
+
+/**
+* @brief Earliest deadline within one wheel revolution.
+*
+* Lets the caller sleep until there is work instead of waking every tick.
+* A level-0 bucket only holds entries due on its next visit, so this
+* reads one word per bucket; a tick on which a non-empty higher-level
+* bucket moves down is reported too, as its entries may be due on it.
+*
+* @param w Pointer to the wheel.
+*
+* @return Absolute tick of the next deadline, or now + SCHED_WHEEL_SLOTS if none is closer
+*/
+uint32_t sched_next_deadline(const sched_wheel_t *w)
+{
+    if (w == NULL) {
+        return 0U;
+    }
+
+    for (uint32_t t = w->now + 1U; t != w->now + SCHED_WHEEL_SLOTS; t++) {
+        if (w->bucket[0][t & SCHED_SLOT_MASK] != SCHED_NONE || sched_cascades_at(w, t)) {
+            return t;
+        }
+    }
+
+    return w->now + SCHED_WHEEL_SLOTS;
+}
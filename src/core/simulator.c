@@ -0,0 +1,282 @@
+/**
+* @file simulator.c
+* @brief Synthetic sensor signals with physical models and fault injection.
+*
+* Per sample a channel costs one or two xorshift32 steps, up to three
+* table-free sine evaluations (parabolic approximation, about 0.1 %
+* error) and a handful of integer multiplies. Divisions happen only at
+* init and while a ramp fault is in progress.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "simulator.h"
+
+/** @brief Phase advance per ms of a Q16.16 frequency in Hz (2^32 = one cycle) - usable in constant expressions */
+#define PHASE_STEP(hz)      ((uint32_t)(((uint64_t)(uint32_t)(hz) << 16) / 1000U))
+
+/**
+* @brief Model shape relative to the half-width of the operating range.
+*/
+typedef struct {
+    uint8_t amplitude_div;      /**< Model swing = half range / amplitude_div */
+    uint8_t noise_div;          /**< Noise standard deviation = half range / noise_div */
+    q16_t   frequency_hz;       /**< Fundamental of the model (0: none) */
+} sim_model_params_t;
+
+static const sim_model_params_t model_params[] = {
+    [SIM_MODEL_THERMAL]   = { 4U, 64U, 0 },
+    [SIM_MODEL_PRESSURE]  = { 3U, 32U, SIM_PUMP_HZ },
+    [SIM_MODEL_VIBRATION] = { 3U, 16U, SIM_RUNNING_SPEED_HZ },
+};
+
+/**
+* @brief Next value of a xorshift32 generator.
+*/
+static inline uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+* @brief Approximately standard normal sample in Q16.16.
+*
+* Sum of the four bytes of one generator output (Irwin-Hall, mean 510,
+* standard deviation 147.8), centred and scaled to unit deviation.
+*/
+static inline q16_t gauss(uint32_t *state)
+{
+    uint32_t r = xorshift32(state);
+    int32_t sum = (int32_t)(r & 0xFFU) + (int32_t)((r >> 8) & 0xFFU) +
+                  (int32_t)((r >> 16) & 0xFFU) + (int32_t)(r >> 24);
+
+    return (sum - 510) * 443;
+}
+
+/**
+* @brief Sine of a phase (2^32 = one cycle) in Q16.16.
+*
+* Parabola through the zeros and peaks, refined by one correction step.
+*/
+static inline q16_t sine(uint32_t phase)
+{
+    // Angle in [-pi, pi) as Q15 in [-1, 1)
+    int32_t x  = (int32_t)phase >> 16;
+    int32_t ax = (x < 0) ? -x : x;
+    int32_t y  = (4 * x * (32768 - ax)) >> 15;
+    int32_t ay = (y < 0) ? -y : y;
+
+    y += (7373 * (((y * ay) >> 15) - y)) >> 15;     // 0.225 in Q15
+    return y * 2;
+}
+
+/**
+* @brief Product of two Q16.16 values.
+*/
+static inline q16_t mul(q16_t a, q16_t b)
+{
+    return (q16_t)(((int64_t)a * b) >> Q16_FRAC_BITS);
+}
+
+/**
+* @brief Healthy output of the channel's model at t_ms.
+*/
+static q16_t model_sample(sim_channel_t *ch, uint32_t t_ms)
+{
+    q16_t v;
+
+    switch (ch->model) {
+    case SIM_MODEL_PRESSURE:
+        v = ch->base + mul(sine(ch->phase_step * t_ms), ch->amplitude);
+        break;
+
+    case SIM_MODEL_VIBRATION: {
+        uint32_t phase = ch->phase_step * t_ms;
+        q16_t shape = sine(phase) + (sine(2U * phase) >> 1) +
+                      (sine(PHASE_STEP(SIM_BEARING_HZ) * t_ms) >> 3);
+        v = ch->base + mul(shape, ch->amplitude);
+        break;
+    }
+
+    case SIM_MODEL_THERMAL:
+    default:
+        // Setpoint wanders within +-amplitude; the temperature lags behind it
+        ch->drift += mul(gauss(&ch->rng), ch->noise) >> 3;
+        if (ch->drift > ch->amplitude) {
+            ch->drift = ch->amplitude;
+        } else if (ch->drift < -ch->amplitude) {
+            ch->drift = -ch->amplitude;
+        }
+        ch->level += (ch->base + ch->drift - ch->level) >> 5;
+        v = ch->level;
+        break;
+    }
+
+    return v + mul(gauss(&ch->rng), ch->noise);
+}
+
+/**
+* @brief Set up a channel for its model and operating range.
+*
+* @param ch    Pointer to the channel state.
+* @param model Signal model.
+* @param min   Lower bound of the operating range.
+* @param max   Upper bound of the operating range.
+* @param seed  Generator seed - channels with different seeds are uncorrelated.
+*/
+void sim_init(sim_channel_t *ch, sim_model_t model, pm_value_t min, pm_value_t max, uint32_t seed)
+{
+    if (ch == NULL) {
+        return;
+    }
+
+    if ((uint32_t)model >= (uint32_t)(sizeof(model_params) / sizeof(model_params[0]))) {
+        model = SIM_MODEL_THERMAL;
+    }
+
+    const sim_model_params_t *p = &model_params[model];
+    q16_t lo   = pm_value_to_q16(min);
+    q16_t half = q16_sat(((int64_t)pm_value_to_q16(max) - lo) / 2);
+
+    // Spread consecutive seeds over the state space
+    ch->rng = seed * 0x9E3779B9U;
+    if (ch->rng == 0U) {
+        ch->rng = 0x9E3779B9U;
+    }
+
+    ch->model      = (uint8_t)model;
+    ch->base       = lo + half;
+    ch->amplitude  = half / (q16_t)p->amplitude_div;
+    ch->noise      = half / (q16_t)p->noise_div;
+    ch->level      = ch->base;
+    ch->drift      = 0;
+    ch->phase_step = PHASE_STEP(p->frequency_hz);
+    ch->last       = ch->base;
+    sim_clear_fault(ch);
+}
+
+/**
+* @brief Schedule a fault on a channel, replacing any previous one.
+*/
+void sim_inject(sim_channel_t *ch, const sim_fault_t *fault)
+{
+    if (ch == NULL || fault == NULL) {
+        return;
+    }
+
+    ch->fault = *fault;
+}
+
+/**
+* @brief Remove the channel's fault - the model output is healthy again.
+*/
+void sim_clear_fault(sim_channel_t *ch)
+{
+    if (ch == NULL) {
+        return;
+    }
+
+    ch->fault.kind        = SIM_FAULT_NONE;
+    ch->fault.start_ms    = 0U;
+    ch->fault.duration_ms = 0U;
+    ch->fault.magnitude   = 0;
+}
+
+/**
+* @brief Whether the channel's fault alters its output at t_ms.
+*
+* A ramp keeps its full offset after its duration (degradation does not
+* heal), so it stays active from its onset on.
+*/
+bool sim_fault_active(const sim_channel_t *ch, uint32_t t_ms)
+{
+    if (ch == NULL || ch->fault.kind == SIM_FAULT_NONE) {
+        return false;
+    }
+
+    uint32_t age = t_ms - ch->fault.start_ms;
+    if ((int32_t)age < 0) {
+        return false;
+    }
+
+    return (ch->fault.kind == SIM_FAULT_RAMP) || (ch->fault.duration_ms == 0U) ||
+           (age < ch->fault.duration_ms);
+}
+
+/**
+* @brief Produce the channel's sample for t_ms.
+*
+* Timestamps must not go backwards; the model state (thermal lag, noise)
+* advances by one sample per call.
+*
+* @return Model output with the channel's fault applied
+*/
+pm_value_t sim_sample(sim_channel_t *ch, uint32_t t_ms)
+{
+    if (ch == NULL) {
+        return 0;
+    }
+
+    q16_t v = model_sample(ch, t_ms);
+
+    if (sim_fault_active(ch, t_ms)) {
+        const sim_fault_t *f = &ch->fault;
+        uint32_t age = t_ms - f->start_ms;
+
+        // A stuck sensor holds the last model output, never a faulted one
+        if (f->kind != SIM_FAULT_STUCK) {
+            ch->last = v;
+        }
+
+        switch (f->kind) {
+        case SIM_FAULT_RAMP:
+            if (f->duration_ms != 0U && age < f->duration_ms) {
+                v = q16_sat((int64_t)v + ((int64_t)f->magnitude * age) / (int64_t)f->duration_ms);
+            } else {
+                v = q16_sat((int64_t)v + f->magnitude);
+            }
+            break;
+
+        case SIM_FAULT_SPIKE:
+            v = q16_sat((int64_t)v + f->magnitude);
+            break;
+
+        case SIM_FAULT_STUCK:
+        default:
+            return pm_value_from_q16(ch->last);
+        }
+        return pm_value_from_q16(v);
+    }
+
+    ch->last = v;
+    return pm_value_from_q16(v);
+}
+
+/**
+* @brief Produce count consecutive samples of a channel.
+*
+* @param ch        Pointer to the channel state.
+* @param t_ms      Timestamp of the first sample.
+* @param period_ms Sampling period.
+* @param out       Output array of count samples.
+* @param count     Number of samples.
+*/
+void sim_fill(sim_channel_t *ch, uint32_t t_ms, uint32_t period_ms, pm_value_t *out, uint32_t count)
+{
+    if (ch == NULL || out == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0U; i < count; i++) {
+        out[i] = sim_sample(ch, t_ms);
+        t_ms  += period_ms;
+    }
+}
@@ -0,0 +1,266 @@
+/**
+ * @file spectrum.cpp
+ * @brief Radix-2 real FFT with ROM-resident tables and vibration band energies.
+ * 
+ * The Hann window, twiddle factors and bit-reversal permutation are
+ * generated at compile time by constexpr functions and stored as const
+ * data, so nothing is computed at boot and nothing is allocated at run
+ * time. A SPECTRUM_FFT_SIZE-point real frame is transformed as a half-size
+ * complex FFT followed by a split step, so one frame costs a fixed
+ * O(N log N) with a single static work buffer.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "spectrum.h"
+
+namespace {
+
+constexpr uint32_t kN     = SPECTRUM_FFT_SIZE;      // Real frame length
+constexpr uint32_t kHalf  = kN / 2U;                // Complex FFT length
+constexpr double   kPi    = 3.14159265358979323846;
+
+static_assert(kN >= 4U && (kN & (kN - 1U)) == 0U, "SPECTRUM_FFT_SIZE must be a power of two");
+
+// Compile-time sine: reduce to [-pi, pi], then a Taylor series accurate well past float precision
+constexpr double ct_sin(double x)
+{
+    while (x > kPi) {
+        x -= 2.0 * kPi;
+    }
+    while (x < -kPi) {
+        x += 2.0 * kPi;
+    }
+
+    double term = x;
+    double sum  = x;
+    for (int n = 1; n < 16; n++) {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum  += term;
+    }
+    return sum;
+}
+
+constexpr double ct_cos(double x)
+{
+    return ct_sin(x + kPi / 2.0);
+}
+
+constexpr uint32_t ct_log2(uint32_t n)
+{
+    uint32_t bits = 0U;
+    while (n > 1U) {
+        n >>= 1U;
+        bits++;
+    }
+    return bits;
+}
+
+struct Tables {
+    float    window[kN];            // Hann window
+    float    cosTw[kHalf];          // cos(2*pi*k/N)
+    float    sinTw[kHalf];          // sin(2*pi*k/N)
+    uint16_t bitrev[kHalf];         // Bit-reversal permutation of the half-size FFT
+};
+
+constexpr Tables makeTables()
+{
+    Tables t{};
+    constexpr uint32_t bits = ct_log2(kHalf);
+
+    for (uint32_t n = 0U; n < kN; n++) {
+        t.window[n] = static_cast<float>(0.5 - 0.5 * ct_cos(2.0 * kPi * n / kN));
+    }
+
+    for (uint32_t k = 0U; k < kHalf; k++) {
+        t.cosTw[k] = static_cast<float>(ct_cos(2.0 * kPi * k / kN));
+        t.sinTw[k] = static_cast<float>(ct_sin(2.0 * kPi * k / kN));
+
+        uint32_t r = 0U;
+        for (uint32_t b = 0U; b < bits; b++) {
+            r |= ((k >> b) & 1U) << (bits - 1U - b);
+        }
+        t.bitrev[k] = static_cast<uint16_t>(r);
+    }
+    return t;
+}
+
+// Placed in flash as const data - no runtime construction
+constexpr Tables kTables = makeTables();
+
+// Work buffer for the half-size complex FFT (only the detection thread runs the FFT)
+float re[kHalf];
+float im[kHalf];
+
+/**
+ * @brief In-place iterative radix-2 DIT FFT of kHalf complex points.
+ *
+ * Twiddles of the half-size FFT are every second entry of the N-point tables.
+*/
+void fftHalf()
+{
+    for (uint32_t i = 0U; i < kHalf; i++) {
+        uint32_t j = kTables.bitrev[i];
+        if (j > i) {
+            float tr = re[i]; re[i] = re[j]; re[j] = tr;
+            float ti = im[i]; im[i] = im[j]; im[j] = ti;
+        }
+    }
+
+    for (uint32_t len = 2U; len <= kHalf; len <<= 1U) {
+        uint32_t half   = len / 2U;
+        uint32_t stride = (kN / len);           // Twiddle step in the N-point table
+        for (uint32_t start = 0U; start < kHalf; start += len) {
+            for (uint32_t k = 0U; k < half; k++) {
+                float wr =  kTables.cosTw[k * stride];
+                float wi = -kTables.sinTw[k * stride];
+                uint32_t a = start + k;
+                uint32_t b = a + half;
+                float xr = re[b] * wr - im[b] * wi;
+                float xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sum of power bins whose centre frequency lies in [lo, hi].
+*/
+float bandEnergy(const float *power, float binHz, float lo, float hi)
+{
+    if (hi < lo || binHz <= 0.0f) {
+        return 0.0f;
+    }
+
+    uint32_t first = static_cast<uint32_t>(lo / binHz + 0.5f);
+    uint32_t last  = static_cast<uint32_t>(hi / binHz + 0.5f);
+    if (first < 1U) {
+        first = 1U;             // Exclude DC
+    }
+    if (last >= SPECTRUM_BINS) {
+        last = SPECTRUM_BINS - 1U;
+    }
+
+    float energy = 0.0f;
+    for (uint32_t k = first; k <= last; k++) {
+        energy += power[k];
+    }
+    return energy;
+}
+
+// Power spectrum of the last analyzed frame
+float power[SPECTRUM_BINS];
+
+} // namespace
+
+/**
+ * @brief Compute band-energy features of one frame.
+ *
+ * Runs in bounded time with no heap allocation. Not reentrant - call from
+ * a single thread.
+ *
+ * @param frame SPECTRUM_FFT_SIZE time-domain samples.
+ * @param cfg   Sampling rate, running speed and bearing band of the machine.
+ * @param out   Receives the features.
+ *
+ * @return true on success, false if a NULL pointer or invalid sampling rate was provided
+*/
+extern "C" bool spectrum_analyze(const float *frame, const spectrum_config_t *cfg, spectrum_features_t *out)
+{
+    if (frame == nullptr || cfg == nullptr || out == nullptr || cfg->sample_rate_hz <= 0.0f) {
+        return false;
+    }
+
+    // Remove the mean so DC leakage does not swamp the low-order bands
+    float mean = 0.0f;
+    for (uint32_t n = 0U; n < kN; n++) {
+        mean += frame[n];
+    }
+    mean /= static_cast<float>(kN);
+
+    // Pack even/odd windowed samples as one half-size complex sequence
+    for (uint32_t n = 0U; n < kHalf; n++) {
+        re[n] = (frame[2U * n]      - mean) * kTables.window[2U * n];
+        im[n] = (frame[2U * n + 1U] - mean) * kTables.window[2U * n + 1U];
+    }
+
+    fftHalf();
+
+    // Split step: recover the N-point real spectrum from the half-size complex one
+    for (uint32_t k = 0U; k < kHalf; k++) {
+        uint32_t m  = (k == 0U) ? 0U : kHalf - k;
+        float zr = re[k], zi = im[k];
+        float cr = re[m], ci = -im[m];          // conj(Z[N/2 - k])
+
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);     // Even part
+        float orr = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);   // Odd part (-i/2 * (Z - conj))
+
+        float wr = kTables.cosTw[k], wi = -kTables.sinTw[k];
+        float xr = er + orr * wr - oi * wi;
+        float xi = ei + orr * wi + oi * wr;
+
+        power[k] = xr * xr + xi * xi;
+    }
+
+    float binHz = cfg->sample_rate_hz / static_cast<float>(kN);
+    float rpm   = cfg->running_speed_hz;
+    float tol   = SPECTRUM_ORDER_TOLERANCE;
+
+    out->total_energy = bandEnergy(power, binHz, binHz, cfg->sample_rate_hz / 2.0f);
+    out->band_1x      = bandEnergy(power, binHz, rpm * (1.0f - tol), rpm * (1.0f + tol));
+    out->band_2x      = bandEnergy(power, binHz, 2.0f * rpm * (1.0f - tol), 2.0f * rpm * (1.0f + tol));
+    out->band_bearing = bandEnergy(power, binHz, cfg->bearing_lo_hz, cfg->bearing_hi_hz);
+
+    uint32_t peak = 1U;
+    for (uint32_t k = 2U; k < SPECTRUM_BINS; k++) {
+        if (power[k] > power[peak]) {
+            peak = k;
+        }
+    }
+    out->peak_hz = static_cast<float>(peak) * binHz;
+
+    return true;
+}
+
+/**
+ * @brief Reset a frame accumulator.
+*/
+extern "C" void spectrum_frame_init(spectrum_frame_t *frame)
+{
+    if (frame == nullptr) {
+        return;
+    }
+    frame->fill = 0U;
+}
+
+/**
+ * @brief Append a sample and analyze the frame once it is full.
+ *
+ * @param frame Frame accumulator of the channel.
+ * @param value New vibration sample.
+ * @param cfg   Analysis parameters of the machine.
+ * @param out   Receives the features when a frame completes.
+ *
+ * @return true if a frame completed and out was filled
+*/
+extern "C" bool spectrum_frame_push(spectrum_frame_t *frame, float value, const spectrum_config_t *cfg,
+                                    spectrum_features_t *out)
+{
+    if (frame == nullptr) {
+        return false;
+    }
+
+    frame->samples[frame->fill++] = value;
+    if (frame->fill < kN) {
+        return false;
+    }
+
+    frame->fill = 0U;
+    return spectrum_analyze(frame->samples, cfg, out);
+}
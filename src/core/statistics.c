@@ -0,0 +1,208 @@
+/**
+* @file statistics.c
+* @brief Streaming per-sensor statistics engine.
+*
+* Every update is O(1) and touches only the sensor's own fixed-size state:
+*  - Welford's algorithm for a numerically stable running mean/variance,
+*    with Kahan-compensated float accumulators so it stays accurate over
+*    unbounded runs without double arithmetic
+*  - EWMA with a configurable smoothing factor
+*  - running min/max
+*  - z-score of each new sample against the statistics seen so far
+*
+* With CONFIG_PM_FIXED_POINT the same algorithms run in integer
+* arithmetic: Q16.16 values with 64-bit intermediates, a Q32.32 Welford
+* mean, a Q15 EWMA factor and an integer square root.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "statistics.h"
+
+#ifndef CONFIG_PM_FIXED_POINT
+/**
+* @brief Kahan summation step: add x to *sum, carrying the rounding error in *comp.
+*/
+static inline void kahan_add(float *sum, float *comp, float x)
+{
+    float y = x - *comp;
+    float t = *sum + y;
+
+    *comp = (t - *sum) - y;
+    *sum  = t;
+}
+#endif
+
+/**
+* @brief Reset a sensor's statistics.
+*
+* @param st    Pointer to the statistics state.
+* @param alpha EWMA smoothing factor; out-of-range values fall back to STATS_EWMA_ALPHA.
+*/
+void stats_init(sensor_stats_t *st, float alpha)
+{
+    if (st == NULL) {
+        return;
+    }
+
+    if (!(alpha > 0.0f && alpha <= 1.0f)) {
+        alpha = STATS_EWMA_ALPHA;
+    }
+
+    st->count = 0U;
+    st->mean  = 0;
+    st->m2    = 0;
+    st->ewma  = 0;
+#ifdef CONFIG_PM_FIXED_POINT
+    // One float conversion at init - 1.0 saturates to the largest Q15 factor
+    st->alpha = (alpha >= 1.0f) ? INT16_MAX : Q15_CONST(alpha);
+#else
+    st->alpha  = alpha;
+    st->mean_c = 0.0f;
+    st->m2_c   = 0.0f;
+#endif
+    st->min   = 0;
+    st->max   = 0;
+}
+
+/**
+* @brief Fold one sample into the statistics.
+*
+* The z-score is computed against the state before the sample is added,
+* so an outlier does not dilute its own score.
+*
+* @param st    Pointer to the statistics state.
+* @param value New sample.
+*
+* @return z-score of the sample (0 while fewer than two samples were seen)
+*/
+pm_value_t stats_update(sensor_stats_t *st, pm_value_t value)
+{
+    if (st == NULL) {
+        return 0;
+    }
+
+    pm_value_t z = stats_zscore(st, value);
+
+    if (st->count == 0U) {
+        st->ewma = value;
+        st->min  = value;
+        st->max  = value;
+    } else {
+#ifdef CONFIG_PM_FIXED_POINT
+        st->ewma += (q16_t)(((int64_t)st->alpha * ((int64_t)value - st->ewma)) >> 15);
+#else
+        st->ewma += st->alpha * (value - st->ewma);
+#endif
+        if (value < st->min) {
+            st->min = value;
+        }
+        if (value > st->max) {
+            st->max = value;
+        }
+    }
+
+    // Welford: mean and M2 updated with the deviation before and after the new mean
+    st->count++;
+#ifdef CONFIG_PM_FIXED_POINT
+    int64_t x     = (int64_t)value << Q16_FRAC_BITS;
+    int64_t delta = x - st->mean;
+    st->mean += delta / (int64_t)st->count;
+    st->m2   += ((delta >> Q16_FRAC_BITS) * ((x - st->mean) >> Q16_FRAC_BITS)) >> Q16_FRAC_BITS;
+#else
+    float delta = value - st->mean;
+    kahan_add(&st->mean, &st->mean_c, delta / (float)st->count);
+    kahan_add(&st->m2, &st->m2_c, delta * (value - st->mean));
+#endif
+
+    return z;
+}
+
+/**
+* @brief Running mean of the samples seen so far (0 before the first one).
+*/
+pm_value_t stats_mean(const sensor_stats_t *st)
+{
+    if (st == NULL) {
+        return 0;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_sat((st->mean + ((int64_t)1 << (Q16_FRAC_BITS - 1))) >> Q16_FRAC_BITS);
+#else
+    return st->mean;
+#endif
+}
+
+/**
+* @brief Sample variance of the samples seen so far (saturated in fixed point).
+*/
+pm_value_t stats_variance(const sensor_stats_t *st)
+{
+    if (st == NULL || st->count < 2U) {
+        return 0;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_div_int(st->m2, st->count - 1U);
+#else
+    return st->m2 / (float)(st->count - 1U);
+#endif
+}
+
+/**
+* @brief Sample standard deviation of the samples seen so far.
+*/
+pm_value_t stats_stddev(const sensor_stats_t *st)
+{
+#ifdef CONFIG_PM_FIXED_POINT
+    // Root of the unsaturated 64-bit variance, so wide ranges keep their deviation
+    if (st == NULL || st->count < 2U) {
+        return 0;
+    }
+    return q16_sqrt(st->m2 / (int64_t)(st->count - 1U));
+#else
+    return sqrtf(stats_variance(st));
+#endif
+}
+
+/**
+* @brief z-score of a value against the current mean and standard deviation.
+*
+* @return z-score, or 0 when the deviation is not yet defined or is zero
+*/
+pm_value_t stats_zscore(const sensor_stats_t *st, pm_value_t value)
+{
+    pm_value_t sd = stats_stddev(st);
+
+    if (sd <= 0) {
+        return 0;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_div((int64_t)value - stats_mean(st), sd);
+#else
+    return (value - st->mean) / sd;
+#endif
+}
+
+/**
+* @brief z-score anomaly test.
+*
+* @param st        Pointer to the statistics state the z-score was computed from.
+* @param z         z-score returned by stats_update().
+* @param threshold Absolute z-score above which the sample is an outlier.
+*
+* @return true once STATS_WARMUP_SAMPLES have been seen and |z| exceeds the threshold
+*/
+bool stats_is_outlier(const sensor_stats_t *st, pm_value_t z, pm_value_t threshold)
+{
+    if (st == NULL || st->count <= STATS_WARMUP_SAMPLES) {
+        return false;
+    }
+
+    return (z > threshold) || (z < -threshold);
+}
@@ -0,0 +1,430 @@
+/**
+* @file store.c
+* @brief Persistent append-only reading history on a flash partition.
+*
+* Flash layout: the partition is cut into segments of STORE_SEGMENT_SIZE,
+* each cut into pages of STORE_PAGE_SIZE. Pages are programmed in order
+* and never rewritten; the segment after the head is erased as soon as
+* the head segment fills, so the pages from the head onwards are always
+* erased. On boot the newest segment (highest page sequence number) is
+* found and the head resumes at its first erased page.
+*
+* Producer side (store_append) and flash side (store_service) share a
+* ring of page buffers through two free-running counters, like the
+* circular buffer: a page is owned by the producer until it is handed
+* over by advancing 'filled', and by the writer until 'written' passes it.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#include "store.h"
+
+/** @brief Flash partition holding the history (devicetree label history_partition) */
+#define STORE_PARTITION_ID      FIXED_PARTITION_ID(history_partition)
+
+BUILD_ASSERT(STORE_PAGE_RECORDS > 0U, "STORE_PAGE_SIZE too small for one record");
+BUILD_ASSERT((STORE_SEGMENT_SIZE % STORE_PAGE_SIZE) == 0U, "segments must hold whole pages");
+BUILD_ASSERT(STORE_PAGE_BUFFERS >= 2U, "need one page filling while another is written");
+
+/**
+* @brief Page buffer padded to the full page size, so every flash write
+*        covers exactly one page.
+*/
+typedef union {
+    store_page_t page;
+    uint8_t      raw[STORE_PAGE_SIZE];
+} page_buf_t;
+
+static const struct flash_area *fa;
+static bool     ready;
+static uint32_t segment_count;
+static uint32_t pages_per_segment;
+
+/** @brief Next page to program - owned by the writer */
+static uint32_t head_segment;
+static uint32_t head_page;
+static uint32_t next_page_seq;
+
+/** @brief Page ring between store_append() and store_service() */
+static page_buf_t pages[STORE_PAGE_BUFFERS];
+static atomic_t   filled;               /**< Pages handed to the writer (producer) */
+static atomic_t   written;              /**< Pages finished by the writer (consumer) */
+static uint16_t   fill_count;           /**< Records in the page being filled */
+
+static store_stats_t stats;
+
+/** @brief Scratch page for boot-time recovery */
+static store_page_t scan_page;
+
+static uint32_t page_offset(uint32_t segment, uint32_t page)
+{
+    return (segment * STORE_SEGMENT_SIZE) + (page * STORE_PAGE_SIZE);
+}
+
+static uint32_t page_crc(const store_page_t *p)
+{
+    uint32_t crc = crc32_ieee((const uint8_t *)&p->header, offsetof(store_page_header_t, crc));
+    return crc32_ieee_update(crc, (const uint8_t *)p->record, sizeof(p->record));
+}
+
+/**
+* @brief true if the page was never programmed since its segment was erased.
+*/
+static bool page_erased(const store_page_header_t *h)
+{
+    uint8_t e = flash_area_erased_val(fa);
+    return h->magic == (uint16_t)(((uint16_t)e << 8) | e);
+}
+
+static bool page_valid(const store_page_t *p)
+{
+    return p->header.magic == STORE_PAGE_MAGIC &&
+           p->header.count <= STORE_PAGE_RECORDS &&
+           p->header.crc == page_crc(p);
+}
+
+static int erase_segment(uint32_t segment)
+{
+    int rc = flash_area_erase(fa, page_offset(segment, 0U), STORE_SEGMENT_SIZE);
+    if (rc == 0) {
+        stats.segments_erased++;
+    } else {
+        stats.write_errors++;
+    }
+    return rc;
+}
+
+/**
+* @brief Find the newest page in the partition and place the head after it.
+*/
+static int recover_head(void)
+{
+    bool found = false;
+    uint32_t newest = 0U;
+
+    // Newest segment: highest sequence number in a valid first page
+    for (uint32_t s = 0U; s < segment_count; s++) {
+        int rc = flash_area_read(fa, page_offset(s, 0U), &scan_page, sizeof(scan_page));
+        if (rc != 0) {
+            return rc;
+        }
+        if (!page_valid(&scan_page)) {
+            continue;
+        }
+        if (!found || (int32_t)(scan_page.header.page_seq - next_page_seq) >= 0) {
+            found = true;
+            newest = s;
+            next_page_seq = scan_page.header.page_seq + 1U;
+        }
+    }
+
+    if (!found) {
+        head_segment = 0U;
+        head_page = 0U;
+        next_page_seq = 0U;
+        return erase_segment(0U);
+    }
+
+    // Resume at the first erased page of the newest segment
+    head_segment = newest;
+    for (head_page = 1U; head_page < pages_per_segment; head_page++) {
+        int rc = flash_area_read(fa, page_offset(newest, head_page), &scan_page, sizeof(scan_page));
+        if (rc != 0) {
+            return rc;
+        }
+        if (page_erased(&scan_page.header)) {
+            return 0;
+        }
+        if (page_valid(&scan_page)) {
+            next_page_seq = scan_page.header.page_seq + 1U;
+        }
+        // A torn page is left in place - the reader skips it
+    }
+
+    // Newest segment is full - open the next one
+    head_segment = (newest + 1U) % segment_count;
+    head_page = 0U;
+    return erase_segment(head_segment);
+}
+
+/**
+* @brief Open the history partition and recover the write position.
+*
+* Call once before store_append() or store_service() are used.
+*
+* @return 0 on success, -EINVAL if the partition holds fewer than two
+*         segments, or the negative errno of the failing flash operation
+*/
+int store_init(void)
+{
+    int rc = flash_area_open(STORE_PARTITION_ID, &fa);
+    if (rc != 0) {
+        return rc;
+    }
+
+    segment_count = (uint32_t)(fa->fa_size / STORE_SEGMENT_SIZE);
+    pages_per_segment = STORE_SEGMENT_SIZE / STORE_PAGE_SIZE;
+    if (segment_count < 2U) {
+        flash_area_close(fa);
+        return -EINVAL;
+    }
+
+    rc = recover_head();
+    if (rc != 0) {
+        flash_area_close(fa);
+        return rc;
+    }
+
+    ready = true;
+    return 0;
+}
+
+/**
+* @brief Append one reading to the history.
+*
+* Only copies the record into the current page buffer; a full page is
+* handed to the flash writer (store_service()). Single producer.
+*
+* @return false if the store is not initialized or every page buffer is
+*         waiting for flash (the reading is dropped and counted)
+*/
+bool store_append(const struct sensor_reading *reading)
+{
+    if (!ready || reading == NULL) {
+        return false;
+    }
+
+    uint32_t f = (uint32_t)atomic_get(&filled);
+
+    // Start a page only when the writer has released its buffer
+    if (fill_count == 0U && (f - (uint32_t)atomic_get(&written)) >= STORE_PAGE_BUFFERS) {
+        stats.dropped++;
+        return false;
+    }
+
+    store_page_t *p = &pages[f % STORE_PAGE_BUFFERS].page;
+    uint32_t ts = reading->timestamp_ms;
+
+    if (fill_count == 0U) {
+        p->header.t_min_ms = ts;
+        p->header.t_max_ms = ts;
+    } else if ((int32_t)(ts - p->header.t_min_ms) < 0) {
+        p->header.t_min_ms = ts;
+    } else if ((int32_t)(ts - p->header.t_max_ms) > 0) {
+        p->header.t_max_ms = ts;
+    }
+    p->record[fill_count++] = *reading;
+    stats.appended++;
+
+    if (fill_count == STORE_PAGE_RECORDS) {
+        p->header.count = fill_count;
+        fill_count = 0U;
+        (void)atomic_set(&filled, (atomic_val_t)(f + 1U));
+    }
+    return true;
+}
+
+/**
+* @brief Program one full page at the head and advance it.
+*/
+static void write_page(store_page_t *p)
+{
+    p->header.magic    = STORE_PAGE_MAGIC;
+    p->header.page_seq = next_page_seq++;
+    p->header.crc      = page_crc(p);
+
+    if (flash_area_write(fa, page_offset(head_segment, head_page), p, STORE_PAGE_SIZE) == 0) {
+        stats.pages_written++;
+    } else {
+        stats.write_errors++;
+    }
+
+    if (++head_page == pages_per_segment) {
+        // Keep the pages ahead of the head erased - the oldest segment goes
+        head_segment = (head_segment + 1U) % segment_count;
+        head_page = 0U;
+        (void)erase_segment(head_segment);
+    }
+}
+
+/**
+* @brief Write every page handed over by store_append() to flash.
+*
+* Called by the flash writer thread whenever pages are pending.
+*
+* @return Number of pages written
+*/
+uint32_t store_service(void)
+{
+    uint32_t n = 0U;
+
+    if (!ready) {
+        return 0U;
+    }
+
+    uint32_t w = (uint32_t)atomic_get(&written);
+    while (w != (uint32_t)atomic_get(&filled)) {
+        write_page(&pages[w % STORE_PAGE_BUFFERS].page);
+        w++;
+        (void)atomic_set(&written, (atomic_val_t)w);
+        n++;
+    }
+    return n;
+}
+
+/**
+* @brief Full pages handed over by store_append() and not yet written.
+*/
+uint32_t store_pending(void)
+{
+    return (uint32_t)atomic_get(&filled) - (uint32_t)atomic_get(&written);
+}
+
+/**
+* @brief Copy the store counters (a snapshot - may be slightly stale).
+*/
+void store_get_stats(store_stats_t *out)
+{
+    if (out != NULL) {
+        *out = stats;
+    }
+}
+
+/**
+* @brief Read the header of one page.
+*/
+static int read_header(uint32_t segment, uint32_t page, store_page_header_t *h)
+{
+    return flash_area_read(fa, page_offset(segment, page), h, sizeof(*h));
+}
+
+/**
+* @brief Position a cursor at the first page that may hold readings at or
+*        after t_ms.
+*
+* Segments are visited oldest to newest. The start segment is found by a
+* binary search on the time span of each segment's first page, then the
+* pages of that segment are scanned by header only. Readings are returned
+* by store_next() in append order from there, so a few readings slightly
+* older than t_ms may come first; pass 0 to read the whole history.
+*
+* @return 0 on success, -ENODEV if the store is not initialized, -EINVAL
+*         on a NULL cursor, or the negative errno of a failed flash read
+*/
+int store_seek(store_cursor_t *cursor, uint32_t t_ms)
+{
+    if (cursor == NULL) {
+        return -EINVAL;
+    }
+    if (!ready) {
+        return -ENODEV;
+    }
+
+    // Oldest segment follows the head; an empty head segment holds nothing to search
+    uint32_t oldest = (head_segment + 1U) % segment_count;
+    uint32_t n = (head_page == 0U) ? (segment_count - 1U) : segment_count;
+    uint32_t lo = 0U;
+    uint32_t hi = n;
+    store_page_header_t h;
+
+    // Last segment whose first page starts at or before t_ms (unused segments count as before)
+    while (hi - lo > 1U) {
+        uint32_t mid = lo + ((hi - lo) / 2U);
+        int rc = read_header((oldest + mid) % segment_count, 0U, &h);
+        if (rc != 0) {
+            return rc;
+        }
+        if (page_erased(&h) || (int32_t)(h.t_min_ms - t_ms) <= 0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    cursor->segment = (oldest + lo) % segment_count;
+    cursor->segments_left = segment_count - lo;
+    cursor->loaded = false;
+    cursor->index = 0U;
+
+    // Skip the pages of the start segment that end before t_ms
+    for (cursor->page = 0U; cursor->page < pages_per_segment; cursor->page++) {
+        int rc = read_header(cursor->segment, cursor->page, &h);
+        if (rc != 0) {
+            return rc;
+        }
+        if (page_erased(&h) || (int32_t)(h.t_max_ms - t_ms) >= 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+* @brief Read the next reading at a cursor.
+*
+* Pages failing their CRC are skipped. At the end of the log the cursor
+* stays put, so a later call returns readings written since.
+* A cursor overtaken by the writer skips ahead to the oldest surviving
+* segment.
+*
+* @return 0 with *out filled, -ENOENT at the end of the log, -EINVAL on a
+*         NULL argument, -ENODEV if the store is not initialized, or the
+*         negative errno of a failed flash read
+*/
+int store_next(store_cursor_t *cursor, struct sensor_reading *out)
+{
+    if (cursor == NULL || out == NULL) {
+        return -EINVAL;
+    }
+    if (!ready) {
+        return -ENODEV;
+    }
+
+    while (1) {
+        if (cursor->loaded) {
+            if (cursor->index < cursor->buf.header.count) {
+                *out = cursor->buf.record[cursor->index++];
+                return 0;
+            }
+            cursor->loaded = false;
+            cursor->page++;
+        }
+
+        if (cursor->page >= pages_per_segment) {
+            if (cursor->segments_left <= 1U && cursor->segment == head_segment) {
+                return -ENOENT;
+            }
+            if (cursor->segments_left > 1U) {
+                cursor->segments_left--;
+            }
+            cursor->segment = (cursor->segment + 1U) % segment_count;
+            cursor->page = 0U;
+        }
+
+        int rc = flash_area_read(fa, page_offset(cursor->segment, cursor->page),
+                                 &cursor->buf, sizeof(cursor->buf));
+        if (rc != 0) {
+            return rc;
+        }
+
+        if (page_erased(&cursor->buf.header)) {
+            if (cursor->segment == head_segment && cursor->segments_left <= 1U) {
+                return -ENOENT;                         // Caught up with the writer
+            }
+            cursor->page = pages_per_segment;           // Unused, or erased under a lapped cursor
+            continue;
+        }
+        if (!page_valid(&cursor->buf)) {
+            cursor->page++;                             // Torn or corrupt page
+            continue;
+        }
+        cursor->loaded = true;
+        cursor->index = 0U;
+    }
+}
@@ -0,0 +1,192 @@
+/**
+* @file window.c
+* @brief Incremental sliding-window analytics.
+*
+* Every push is amortized O(1):
+*  - moving mean and RMS from running sum / sum of squares, with the sample
+*    leaving the window subtracted out
+*  - moving min/max from monotonic deques - each sample is pushed and
+*    popped at most once per deque
+*
+* To stop float rounding from accumulating in the running sums, they are
+* rebuilt from the window's own ring once every WINDOW_SIZE pushes, which
+* keeps the cost amortized O(1). The integer sums of a fixed-point build
+* (CONFIG_PM_FIXED_POINT) are exact and never need it.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <zephyr/sys/util.h>
+
+#include "window.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(WINDOW_SIZE) && WINDOW_SIZE <= 128U,
+             "WINDOW_SIZE must be a power of two no larger than 128");
+
+/**
+* @brief Contribution of one sample to sum_sq.
+*/
+static inline pm_sum_t square(pm_value_t v)
+{
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_square(v);
+#else
+    return v * v;
+#endif
+}
+
+/**
+* @brief Reset a sensor window to empty.
+*
+* @param w Pointer to the window state.
+*/
+void window_init(sensor_window_t *w)
+{
+    if (w == NULL) {
+        return;
+    }
+
+    w->min_head = w->min_tail = 0U;
+    w->max_head = w->max_tail = 0U;
+    w->count  = 0U;
+    w->sum    = 0;
+    w->sum_sq = 0;
+}
+
+/**
+* @brief Append a sample, evicting the oldest one once the window is full.
+*
+* @param w     Pointer to the window state.
+* @param value New sample.
+*/
+void window_push(sensor_window_t *w, pm_value_t value)
+{
+    if (w == NULL) {
+        return;
+    }
+
+    uint8_t pos = (uint8_t)w->count;
+
+    if (w->count >= WINDOW_SIZE) {
+        // Evict the sample that is about to be overwritten
+        pm_value_t old     = w->samples[pos & WINDOW_MASK];
+        uint8_t    old_pos = (uint8_t)(pos - WINDOW_SIZE);
+
+        w->sum    -= old;
+        w->sum_sq -= square(old);
+
+        if (w->min_dq[w->min_head & WINDOW_MASK] == old_pos) {
+            w->min_head++;
+        }
+        if (w->max_dq[w->max_head & WINDOW_MASK] == old_pos) {
+            w->max_head++;
+        }
+    }
+
+    w->samples[pos & WINDOW_MASK] = value;
+    w->sum    += value;
+    w->sum_sq += square(value);
+
+    // Drop samples that can no longer be the window min / max
+    while (w->min_tail != w->min_head &&
+           w->samples[w->min_dq[(uint8_t)(w->min_tail - 1U) & WINDOW_MASK] & WINDOW_MASK] >= value) {
+        w->min_tail--;
+    }
+    w->min_dq[w->min_tail++ & WINDOW_MASK] = pos;
+
+    while (w->max_tail != w->max_head &&
+           w->samples[w->max_dq[(uint8_t)(w->max_tail - 1U) & WINDOW_MASK] & WINDOW_MASK] <= value) {
+        w->max_tail--;
+    }
+    w->max_dq[w->max_tail++ & WINDOW_MASK] = pos;
+
+    w->count++;
+
+#ifndef CONFIG_PM_FIXED_POINT
+    // Periodically rebuild the running sums to cancel accumulated rounding error
+    if ((w->count & WINDOW_MASK) == 0U) {
+        float sum = 0.0f;
+        float sum_sq = 0.0f;
+        for (uint32_t i = 0U; i < WINDOW_SIZE; i++) {
+            sum    += w->samples[i];
+            sum_sq += w->samples[i] * w->samples[i];
+        }
+        w->sum    = sum;
+        w->sum_sq = sum_sq;
+    }
+#endif
+}
+
+/**
+* @brief Number of samples currently in the window.
+*/
+uint32_t window_length(const sensor_window_t *w)
+{
+    if (w == NULL) {
+        return 0U;
+    }
+
+    return MIN(w->count, WINDOW_SIZE);
+}
+
+/**
+* @brief Moving average of the window (0 if empty).
+*/
+pm_value_t window_mean(const sensor_window_t *w)
+{
+    uint32_t n = window_length(w);
+
+    if (n == 0U) {
+        return 0;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_div_int(w->sum, n);
+#else
+    return w->sum / (float)n;
+#endif
+}
+
+/**
+* @brief Smallest sample in the window (0 if empty).
+*/
+pm_value_t window_min(const sensor_window_t *w)
+{
+    if (window_length(w) == 0U) {
+        return 0;
+    }
+
+    return w->samples[w->min_dq[w->min_head & WINDOW_MASK] & WINDOW_MASK];
+}
+
+/**
+* @brief Largest sample in the window (0 if empty).
+*/
+pm_value_t window_max(const sensor_window_t *w)
+{
+    if (window_length(w) == 0U) {
+        return 0;
+    }
+
+    return w->samples[w->max_dq[w->max_head & WINDOW_MASK] & WINDOW_MASK];
+}
+
+/**
+* @brief Root mean square of the window (0 if empty).
+*/
+pm_value_t window_rms(const sensor_window_t *w)
+{
+    uint32_t n = window_length(w);
+
+    if (n == 0U) {
+        return 0;
+    }
+
+#ifdef CONFIG_PM_FIXED_POINT
+    return q16_sqrt(w->sum_sq / (int64_t)n);
+#else
+    float mean_sq = w->sum_sq / (float)n;
+    return (mean_sq > 0.0f) ? sqrtf(mean_sq) : 0.0f;
+#endif
+}
@@ -0,0 +1,49 @@
+/**
+ * @file registry.cpp
+ * @brief Machine pool and ID lookup for the whole fleet.
+ *
+ * The registry is evaluated from the topology tables at compile time;
+ * topology.h has already rejected any table that would not fit or would
+ * leave a machine without its sensors.
+*/
+
+#include <stdint.h>
+
+#include "registry.h"
+#include "topology.h"
+
+/**
+ * @brief Build the registry from the topology tables.
+ *
+ * Pool indices follow machineTable, sensor slots follow sensorTable.
+*/
+static constexpr Registry buildRegistry()
+{
+    Registry reg;
+
+    for (const MachineConfig& mc : machineTable) {
+        reg.addMachine(mc.id, mc.name, mc.type);
+    }
+    for (uint32_t slot = 0U; slot < FLEET_SENSORS; slot++) {
+        const SensorConfig& s = sensorTable[slot];
+        reg.addSensor(s.machineId, s.type, s.number, static_cast<uint16_t>(slot));
+    }
+
+    return reg;
+}
+
+/** @brief Instantiate the fleet registry in ROM */
+constexpr Registry registry = buildRegistry();
+
+const Machine* Registry::machineAt(uint16_t index) const
+{
+    if (index >= machineCount) {
+        return nullptr;
+    }
+    return &machines[index];
+}
+
+const Machine* Registry::findMachine(uint16_t machineId) const
+{
+    return machineAt(machineIds.find(machineId));
+}
@@ -1,9 +1,10 @@
 /**
  * @file sensor.cpp
- * @brief Implementation of sensors, factory, and Machine logic.
+ * @brief Implementation of sensors and Machine logic.
  * 
- * Contains concrete sensor behavior and runtime composition of machines 
- * and their sensors.
+ * Contains concrete sensor behavior and machine accessors. Sensor state
+ * lives in the sensor layout (static, ROM) and bank (live); sensor objects
+ * and machines only hold slot indices into them.
 */
 
 #include <string.h>
@@ -12,131 +13,123 @@
 #include "sensor.h"
 #include "wrapper.h"
 
-// Static sensor pool (Object pool pattern)
-static TempSensor       tempPool[MAX_TEMP_SENSORS];
-static PressureSensor   pressPool[MAX_PRESS_SENSORS];
-static VibrationSensor  vibPool[MAX_VIB_SENSORS];
-
-// Pool allocation indices
-static uint8_t tempIndex  = 0U;
-static uint8_t pressIndex = 0U;
-static uint8_t vibIndex   = 0U;
-
-// Static Machine Pool
-Machine machinePool[NUM_MACHINES] = {
-    Machine("Station_A_Air_Compressor", AIR_COMPRESSOR),
-    Machine("Station_A_Steam_Boiler", STEAM_BOILER),
-    Machine("Station_A_Electric_Motor", ELECTRIC_MOTOR)
+/**
+ * @brief Display names indexed by SensorType.
+*/
+static const char* const sensorTypeNames[SENSOR_TYPE_COUNT] = {
+    "Temperature",
+    "Pressure",
+    "Vibration"
 };
 
-// Allocate a sensor from the appropriate static pool
-Sensor* SensorFactory::createSensor(const char* type, uint16_t sensorNumber, 
-                                    float minVal, float maxVal)
+extern "C" const char* sensor_type_name(SensorType type)
 {
-    if (type == nullptr) {
-        return nullptr;
-    }
-
-    // Temperature sensor pool
-    if (strcmp(type, "Temperature") == 0 && tempIndex < MAX_TEMP_SENSORS) {
-        // Construct sensor in-place at next available slot
-        tempPool[tempIndex] = TempSensor(sensorNumber, minVal, maxVal);
-        return &tempPool[tempIndex++];
+    if ((unsigned int)type >= SENSOR_TYPE_COUNT) {
+        return "unknown";
     }
+    return sensorTypeNames[type];
+}
 
-    // Pressure sensor pool
-    else if (strcmp(type, "Pressure") == 0 && pressIndex < MAX_PRESS_SENSORS) {
-        pressPool[pressIndex] = PressureSensor(sensorNumber, minVal, maxVal);
-        return &pressPool[pressIndex++];
+extern "C" SensorType sensor_type_from_name(const char* name)
+{
+    if (name != nullptr) {
+        for (uint8_t t = 0U; t < SENSOR_TYPE_COUNT; t++) {
+            if (strcmp(sensorTypeNames[t], name) == 0) {
+                return static_cast<SensorType>(t);
+            }
+        }
     }
+    return SENSOR_TYPE_COUNT;   // Unknown name
+}
 
-    // Vibration sensor pool
-    else if (strcmp(type, "Vibration") == 0 && vibIndex < MAX_VIB_SENSORS) {
-        vibPool[vibIndex] = VibrationSensor(sensorNumber, minVal, maxVal);
-        return &vibPool[vibIndex++];
+uint8_t Machine::findSensor(SensorType sensorType) const
+{
+    if ((unsigned int)sensorType >= SENSOR_TYPE_COUNT) {
+        return SENSOR_INDEX_NONE;
     }
-    
-    return nullptr;     // pool exhausted or unknown type
+    return typeIndex[sensorType];
 }
 
-Machine::Machine(const char* machineName, MachineType machineType)
-    : name(machineName), type(machineType), sensorCount(0U)
+void Machine::setSensorValue(const char* sensorType, float value) const
 {
-    // Initialize sensor array to nullptr
-    for (uint8_t i=0U; i < MAX_SENSORS; i++){
-        sensors[i] = nullptr;
-    }
+    setSensorValueAt(findSensor(sensor_type_from_name(sensorType)), value);
 }
 
-void Machine::addSensor(Sensor* sensor)
+float Machine::getSensorValue(const char* sensorType) const
 {
-    if (sensor == nullptr || sensorCount >= MAX_SENSORS){
-        return;     // Guard against null or full
-    }
+    return getSensorValueAt(findSensor(sensor_type_from_name(sensorType)));
+}
 
-    sensors[sensorCount++] = sensor;
+float Machine::getSensorMinValue(const char* sensorType) const
+{
+    return getSensorMinValueAt(findSensor(sensor_type_from_name(sensorType)));
 }
 
-void Machine::setSensorValue(const char* sensorType, float value)
+float Machine::getSensorMaxValue(const char* sensorType) const
 {
-    if (sensorType == nullptr) {
-        return;     
-    }
+    return getSensorMaxValueAt(findSensor(sensor_type_from_name(sensorType)));
+}
 
-    for (uint8_t i=0U; i < sensorCount; i++) {
-        if (sensors[i] != nullptr && strcmp(sensors[i]->getType(), sensorType) == 0) {
-            sensors[i]->setValue(value);
-            return;
-        }
+void Machine::setSensorValueAt(uint8_t sensorIndex, float value) const
+{
+    if (sensorIndex >= sensorCount) {
+        return;     // Sensor not found
     }
+    sensor_bank_store(firstSlot + sensorIndex, pm_value_from_float(value), k_uptime_get_32());
 }
 
-float Machine::getSensorValue(const char* sensorType) const
+float Machine::getSensorValueAt(uint8_t sensorIndex) const
 {
-    if (sensorType == nullptr) {
-        return 0.0f;     
+    if (sensorIndex >= sensorCount) {
+        return 0.0f;    // Sensor not found
     }
+    return pm_value_to_float(sensor_bank.value[firstSlot + sensorIndex]);
+}
 
-    for (uint8_t i=0U; i < sensorCount; i++) {
-        if (sensors[i] != nullptr && strcmp(sensors[i]->getType(), sensorType) == 0) {
-            return sensors[i]->readValue();
-        }
+float Machine::getSensorMinValueAt(uint8_t sensorIndex) const
+{
+    if (sensorIndex >= sensorCount) {
+        return 0.0f;    // Sensor not found
     }
-    return 0.0f;    // Sensor not found
+    return pm_value_to_float(sensor_layout.min[firstSlot + sensorIndex]);
 }
 
-float Machine::getSensorMinValue(const char* sensorType) const
+float Machine::getSensorMaxValueAt(uint8_t sensorIndex) const
 {
-    if (sensorType == nullptr) {
-        return 0.0f;     
+    if (sensorIndex >= sensorCount) {
+        return 0.0f;    // Sensor not found
     }
+    return pm_value_to_float(sensor_layout.max[firstSlot + sensorIndex]);
+}
 
-    for (uint8_t i=0U; i < sensorCount; i++) {
-        if (sensors[i] != nullptr && strcmp(sensors[i]->getType(), sensorType) == 0) {
-            return sensors[i]->getMinValue();
-        }
+SensorType Machine::getSensorKind(uint8_t sensorIndex) const
+{
+    if (sensorIndex >= sensorCount) {
+        return SENSOR_TYPE_COUNT;
     }
-    return 0.0f;    // Sensor not found
+    return static_cast<SensorType>(sensor_layout.type[firstSlot + sensorIndex]);
 }
 
-float Machine::getSensorMaxValue(const char* sensorType) const
+const char* Machine::getSensorType(uint8_t sensorIndex) const
 {
-    if (sensorType == nullptr) {
-        return 0.0f;     
+    if (sensorIndex >= sensorCount) {
+        return "unknown";
     }
+    return sensor_type_name(getSensorKind(sensorIndex));
+}
 
-    for (uint8_t i=0U; i < sensorCount; i++) {
-        if (sensors[i] != nullptr && strcmp(sensors[i]->getType(), sensorType) == 0) {
-            return sensors[i]->getMaxValue();
-        }
+uint16_t Machine::getSensorId(uint8_t sensorIndex) const
+{
+    if (sensorIndex >= sensorCount) {
+        return UINT16_MAX;
     }
-    return 0.0f;    // Sensor not found
+    return sensor_layout.number[firstSlot + sensorIndex];
 }
 
-const char* Machine::getSensorType(uint8_t sensorIndex) const
+uint16_t Machine::getSensorSlot(uint8_t sensorIndex) const
 {
-    if (sensorIndex >= sensorCount || sensors[sensorIndex] == nullptr) {
-        return "unknown";
+    if (sensorIndex >= sensorCount) {
+        return SENSOR_SLOT_NONE;
     }
-    return sensors[sensorIndex]->getType();
+    return firstSlot + sensorIndex;
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file sensor_bank.cpp
+ * @brief Structure-of-arrays sensor storage.
+ *
+ * The sensor layout is computed from the topology tables by the compiler,
+ * so it is emitted as const data in ROM and costs nothing at boot.
+*/
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+#include "sensor_bank.h"
+#include "topology.h"
+
+/**
+ * @brief Build the sensor layout from the topology tables.
+ *
+ * Slots follow the order of sensorTable; a sensor's index within its
+ * machine is its distance from the machine's first slot.
+*/
+static constexpr SensorLayout buildLayout()
+{
+    SensorLayout layout{};
+
+    for (uint32_t slot = 0U; slot < FLEET_SENSORS; slot++) {
+        const SensorConfig& s = sensorTable[slot];
+        bool sameMachine = (slot > 0U) && (sensorTable[slot - 1U].machineId == s.machineId);
+
+        layout.min[slot]       = PM_VALUE(s.minValue);
+        layout.max[slot]       = PM_VALUE(s.maxValue);
+        layout.number[slot]    = s.number;
+        layout.type[slot]      = static_cast<uint8_t>(s.type);
+        layout.machine[slot]   = static_cast<uint16_t>(topology::machineIndex(s.machineId));
+        layout.index[slot]     = sameMachine ? static_cast<uint8_t>(layout.index[slot - 1U] + 1U) : 0U;
+        layout.period_ms[slot] = s.periodMs;
+    }
+    layout.count = static_cast<uint16_t>(FLEET_SENSORS);
+
+    return layout;
+}
+
+/** @brief Instantiate the sensor layout in ROM */
+constexpr SensorLayout sensor_layout = buildLayout();
+
+/** @brief Instantiate the sensor bank */
+SensorBank sensor_bank;
+
+/** @brief Serializes writers of the sensor bank - held only for a few stores, readers never take it */
+static struct k_spinlock write_lock;
+
+/**
+ * @brief Publish new values of several sensors of one machine, all from the same instant.
+ *
+ * Stores every value and the acquisition time inside one write of the
+ * machine's sequence lock, so a reader sees either all of them or none,
+ * and marks the slots for collection by sensor_read. A value that
+ * replaces one not collected yet is counted in sensor_bank.overwritten.
+ *
+ * @param machine      Pool index of the machine owning the slots.
+ * @param slots        Slots to update (entries not owned by the machine are ignored).
+ * @param values       New values, one per slot.
+ * @param count        Number of slots.
+ * @param timestamp_ms Acquisition time (ms since boot).
+*/
+void sensor_bank_store_n(uint16_t machine, const uint16_t *slots, const pm_value_t *values,
+                         uint32_t count, uint32_t timestamp_ms)
+{
+    if (slots == nullptr || values == nullptr || machine >= MAX_FLEET_MACHINES) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&write_lock);
+    sensor_bank_write_begin(machine);
+    for (uint32_t i = 0U; i < count; i++) {
+        uint16_t slot = slots[i];
+        if (slot < sensor_layout.count && sensor_layout.machine[slot] == machine) {
+            sensor_bank.value[slot]        = values[i];
+            sensor_bank.timestamp_ms[slot] = timestamp_ms;
+        }
+    }
+    sensor_bank_write_end(machine);
+    k_spin_unlock(&write_lock, key);
+
+    // Tell sensor_read these slots have values it has not collected yet - if a
+    // previous one is still uncollected it is lost, and counted as such
+    for (uint32_t i = 0U; i < count; i++) {
+        uint16_t slot = slots[i];
+        if (slot < sensor_layout.count && sensor_layout.machine[slot] == machine &&
+            atomic_test_and_set_bit(sensor_bank.updated, slot)) {
+            (void)atomic_inc(&sensor_bank.overwritten);
+        }
+    }
+}
+
+/**
+ * @brief Publish a new value of one sensor.
+ *
+ * @param slot         Sensor bank slot (ignored if invalid).
+ * @param value        New value.
+ * @param timestamp_ms Acquisition time (ms since boot).
+*/
+void sensor_bank_store(uint16_t slot, pm_value_t value, uint32_t timestamp_ms)
+{
+    if (slot >= sensor_layout.count) {
+        return;
+    }
+
+    sensor_bank_store_n(sensor_layout.machine[slot], &slot, &value, 1U, timestamp_ms);
+}
+
+/**
+ * @brief Copy the values of a run of one machine's sensors, all from the same instant.
+ *
+ * Lock-free: the copy is repeated if sensor_write updated the machine
+ * meanwhile. value and timestamp_ms receive count entries each.
+ *
+ * @param machine      Pool index of the machine owning the slots.
+ * @param first_slot   First slot to copy.
+ * @param count        Number of consecutive slots to copy.
+ * @param value        Receives the values.
+ * @param timestamp_ms Receives the acquisition times (may be NULL).
+ *
+ * @return Number of slots copied (0 on an invalid machine, or a range
+ *         not entirely owned by that machine)
+*/
+uint8_t sensor_bank_snapshot(uint16_t machine, uint16_t first_slot, uint8_t count,
+                             pm_value_t *value, uint32_t *timestamp_ms)
+{
+    if (value == nullptr || machine >= MAX_FLEET_MACHINES || count == 0U ||
+        (static_cast<uint32_t>(first_slot) + count) > sensor_layout.count) {
+        return 0U;
+    }
+
+    // A machine's slots are contiguous - both ends inside it means the whole run is
+    if (sensor_layout.machine[first_slot] != machine ||
+        sensor_layout.machine[first_slot + count - 1U] != machine) {
+        return 0U;
+    }
+
+    uint32_t seq;
+    do {
+        seq = sensor_bank_read_begin(machine);
+        for (uint8_t i = 0U; i < count; i++) {
+            value[i] = sensor_bank.value[first_slot + i];
+            if (timestamp_ms != nullptr) {
+                timestamp_ms[i] = sensor_bank.timestamp_ms[first_slot + i];
+            }
+        }
+    } while (sensor_bank_read_retry(machine, seq));
+
+    return count;
+}
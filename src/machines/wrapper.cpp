@@ -10,34 +10,35 @@
 
 #include "wrapper.h"
 #include "sensor.h"
+#include "registry.h"
 
-extern Machine machinePool[NUM_MACHINES];
-
-extern "C" void generate_machines_and_sensors(void) 
+extern "C" uint16_t get_machine_count(void)
 {
-    //printk("Starting machine generation...\n");
-    
-    // Air Compressor: Temperature (60-100°C), Pressure (72-145 psi), Vibration (0.5-2.0 mm/s)
-    machinePool[0].addSensor(SensorFactory::createSensor("Temperature", 0,  60.0f,  100.0f));
-    machinePool[0].addSensor(SensorFactory::createSensor("Pressure",    1,  72.0f,  145.0f));
-    machinePool[0].addSensor(SensorFactory::createSensor("Vibration",   2,   0.5f,    2.0f));
+    return registry.getMachineCount();
+}
 
-    // Steam Boiler: Temperature (150-250°C), Pressure (87-360 psi)
-    machinePool[1].addSensor(SensorFactory::createSensor("Temperature", 3, 150.0f,  250.0f));
-    machinePool[1].addSensor(SensorFactory::createSensor("Pressure",    4,  87.0f,  360.0f));
+extern "C" MachineHandle get_machine(uint16_t index) 
+{
+    return reinterpret_cast<MachineHandle>(const_cast<Machine*>(registry.machineAt(index)));
+}
 
-    // Electric Motor: Temperature (60-105°C)
-    machinePool[2].addSensor(SensorFactory::createSensor("Temperature", 5,  60.0f,  105.0f));
+extern "C" MachineHandle find_machine(uint16_t machineId)
+{
+    return reinterpret_cast<MachineHandle>(const_cast<Machine*>(registry.findMachine(machineId)));
+}
 
-    //printk("Machines and sensors generated\n");
+extern "C" uint16_t find_sensor_slot(uint16_t sensorNumber)
+{
+    return registry.findSensorSlot(sensorNumber);
 }
 
-extern "C" MachineHandle get_machine(uint8_t index) 
+extern "C" uint16_t get_machine_id(MachineHandle machine)
 {
-    if (index >= NUM_MACHINES) {
-        return nullptr;
+    if (machine == nullptr) {
+        return UINT16_MAX;
     }
-    return reinterpret_cast<MachineHandle>(&machinePool[index]);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getId();
 }
 
 extern "C" const char* get_machine_name(MachineHandle machine)
@@ -45,7 +46,7 @@ extern "C" const char* get_machine_name(MachineHandle machine)
     if (machine == nullptr) {
         return "unknown";
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getName();
 }
 
@@ -54,7 +55,7 @@ extern "C" MachineType get_machine_type(MachineHandle machine)
     if (machine == nullptr) {
         return AIR_COMPRESSOR;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getType();
 }
 
@@ -63,7 +64,7 @@ extern "C" void set_sensor_value(MachineHandle machine, const char* sensorType,
     if (machine == nullptr) {
         return;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     m->setSensorValue(sensorType, value);
 }
 
@@ -72,7 +73,7 @@ extern "C" float get_sensor_value(MachineHandle machine, const char* sensorType)
     if (machine == nullptr) {
         return 0.0f;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getSensorValue(sensorType);
 }
 
@@ -81,7 +82,7 @@ extern "C" float get_sensor_min_value(MachineHandle machine, const char* sensorT
     if (machine == nullptr) {
         return 0.0f;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getSensorMinValue(sensorType);
 }
 
@@ -90,7 +91,7 @@ extern "C" float get_sensor_max_value(MachineHandle machine, const char* sensorT
     if (machine == nullptr) {
         return 0.0f;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getSensorMaxValue(sensorType);
 }
 
@@ -99,7 +100,7 @@ extern "C" uint8_t get_sensor_count(MachineHandle machine)
     if (machine == nullptr) {
         return 0U;
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getSensorCount();
 }
 
@@ -108,6 +109,142 @@ extern "C" const char* get_sensor_type(MachineHandle machine, uint8_t sensorInde
     if (machine == nullptr) {
         return "Unknown";
     }
-    Machine* m = reinterpret_cast<Machine*>(machine);
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
     return m->getSensorType(sensorIndex);
 }
+
+
+extern "C" uint16_t get_sensor_id(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return UINT16_MAX;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorId(sensorIndex);
+}
+
+extern "C" SensorType get_sensor_kind(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return SENSOR_TYPE_COUNT;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorKind(sensorIndex);
+}
+
+extern "C" uint8_t get_sensor_index(MachineHandle machine, SensorType sensorType)
+{
+    if (machine == nullptr) {
+        return SENSOR_INDEX_NONE;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->findSensor(sensorType);
+}
+
+extern "C" void set_sensor_value_at(MachineHandle machine, uint8_t sensorIndex, float value)
+{
+    if (machine == nullptr) {
+        return;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    m->setSensorValueAt(sensorIndex, value);
+}
+
+extern "C" float get_sensor_value_at(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return 0.0f;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorValueAt(sensorIndex);
+}
+
+extern "C" float get_sensor_min_value_at(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return 0.0f;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorMinValueAt(sensorIndex);
+}
+
+extern "C" float get_sensor_max_value_at(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return 0.0f;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorMaxValueAt(sensorIndex);
+}
+
+extern "C" uint16_t get_sensor_slot(MachineHandle machine, uint8_t sensorIndex)
+{
+    if (machine == nullptr) {
+        return SENSOR_SLOT_NONE;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+    return m->getSensorSlot(sensorIndex);
+}
+
+/**
+ * @brief Fill one machine's sensors, static part from ROM, live part under the machine's seqlock.
+*/
+static uint8_t fillSensors(const Machine* m, SensorSnapshot* out, uint8_t count)
+{
+    uint16_t first   = m->getFirstSlot();
+    uint16_t machine = m->getIndex();
+
+    for (uint8_t i = 0U; i < count; i++) {
+        uint16_t slot = first + i;
+        out[i].id   = sensor_layout.number[slot];
+        out[i].slot = slot;
+        out[i].type = sensor_layout.type[slot];
+        out[i].min  = pm_value_to_float(sensor_layout.min[slot]);
+        out[i].max  = pm_value_to_float(sensor_layout.max[slot]);
+    }
+
+    uint32_t seq;
+    do {
+        seq = sensor_bank_read_begin(machine);
+        for (uint8_t i = 0U; i < count; i++) {
+            out[i].value        = pm_value_to_float(sensor_bank.value[first + i]);
+            out[i].timestamp_ms = sensor_bank.timestamp_ms[first + i];
+        }
+    } while (sensor_bank_read_retry(machine, seq));
+
+    return count;
+}
+
+extern "C" uint8_t get_machine_snapshot(MachineHandle machine, MachineSnapshot* out)
+{
+    if (machine == nullptr || out == nullptr) {
+        return 0U;
+    }
+    const Machine* m = reinterpret_cast<const Machine*>(machine);
+
+    out->machineId   = m->getId();
+    out->type        = m->getType();
+    out->name        = m->getName();
+    out->sensorCount = fillSensors(m, out->sensors, m->getSensorCount());
+
+    return out->sensorCount;
+}
+
+extern "C" uint32_t read_all_sensors(SensorSnapshot* out, uint32_t maxCount)
+{
+    if (out == nullptr) {
+        return 0U;
+    }
+
+    // Machines own consecutive slot ranges, so the output is in slot order
+    uint32_t filled = 0U;
+    for (uint16_t i = 0U; i < registry.getMachineCount(); i++) {
+        const Machine* m = registry.machineAt(i);
+        if (filled + m->getSensorCount() > maxCount) {
+            break;          // Whole machines only - a partial one would not be a snapshot
+        }
+        filled += fillSensors(m, &out[filled], m->getSensorCount());
+    }
+
+    return filled;
+}
@@ -14,6 +14,11 @@
 #include "threads.h"
 #include "wrapper.h"
 #include "circular_buffer.h"
+#include "sensor_bank.h"
+#include "instrument.h"
+#ifdef CONFIG_PM_STORE
+#include "store.h"
+#endif
 
 /** @brief Stack size in bytes allocated for each thread */
 #define STACK_SIZE      2048U
@@ -24,9 +29,12 @@
 #define PRIORITY_5      5
 #define PRIORITY_6      6
 #define PRIORITY_7      7
+#define PRIORITY_8      8
 
-/** @brief Instantiate the circular buffer */
+/** @brief Instantiate the circular buffer and its readers (declared extern in circular_buffer.h) */
 CircularBuffer circular_buffer;  
+cb_reader_t *detect_reader;
+cb_reader_t *store_reader;
 
 /**
  * @brief Message queue for passing log messages from threads 1-4 to system_logger
@@ -35,10 +43,21 @@ CircularBuffer circular_buffer;
  * Defined here and declared extern in shared_resources.h.
 */
 K_MSGQ_DEFINE(log_queue, sizeof(log_msg_t), LOG_QUEUE_SIZE, MESSAGE_ALIGN);
+BUILD_ASSERT(sizeof(log_msg_t) == 32U, "log_msg_t must stay a compact binary record");
 
-/* */
-K_MUTEX_DEFINE(sensor_mutex);
-K_MUTEX_DEFINE(buffer_mutex);
+/** @brief Event-driven hand-off between pipeline stages (declared extern in shared_resources.h) */
+K_SEM_DEFINE(sensor_update_sem, 0, 1);
+K_SEM_DEFINE(buffer_data_sem, 0, 1);
+K_SEM_DEFINE(store_data_sem, 0, 1);
+K_SEM_DEFINE(store_page_sem, 0, 1);
+K_SEM_DEFINE(buffer_space_sem, 0, 1);
+K_MSGQ_DEFINE(anomaly_queue, sizeof(anomaly_event_t), ANOMALY_QUEUE_SIZE, MESSAGE_ALIGN);
+
+/** @brief Acquisition-to-alert latency (declared extern in shared_resources.h) */
+latency_hist_t alert_latency;
+
+/** @brief Compressed per-sensor history (declared extern in shared_resources.h) */
+history_t sensor_history[MAX_FLEET_SENSORS];
 
 // /** @brief Thread stacks - statically allocated */
 K_THREAD_STACK_DEFINE(sensor_write_stack,    STACK_SIZE);
@@ -46,6 +65,10 @@ K_THREAD_STACK_DEFINE(sensor_read_stack,     STACK_SIZE);
 K_THREAD_STACK_DEFINE(anomaly_detect_stack,  STACK_SIZE);
 K_THREAD_STACK_DEFINE(anomaly_handle_stack,  STACK_SIZE);
 K_THREAD_STACK_DEFINE(system_log_stack,      STACK_SIZE);
+#ifdef CONFIG_PM_STORE
+K_THREAD_STACK_DEFINE(store_write_stack,     STACK_SIZE);
+K_THREAD_STACK_DEFINE(store_fill_stack,      STACK_SIZE);
+#endif
 
 // /** @brief Declare Thread control blocks (TCB holds: priority, stack pointers etc) */
 struct k_thread sensor_write_thread;
@@ -53,6 +76,10 @@ struct k_thread sensor_read_thread;
 struct k_thread anomaly_detect_thread;
 struct k_thread anomaly_handle_thread;
 struct k_thread system_log_thread;
+#ifdef CONFIG_PM_STORE
+struct k_thread store_write_thread;
+struct k_thread store_fill_thread;
+#endif
 
 /**
  * @brief Spawn all application threads.
@@ -71,31 +98,51 @@ static void spawn_threads(void)
                     K_THREAD_STACK_SIZEOF(sensor_write_stack),
                     (k_thread_entry_t)sensor_write,
                     NULL, NULL, NULL, PRIORITY_3, 0, K_NO_WAIT);
+    INSTR_THREAD(&sensor_write_thread, "sensor_write");
     //printk("sensor_write thread created\n");
 
     k_thread_create(&sensor_read_thread, sensor_read_stack,
                     K_THREAD_STACK_SIZEOF(sensor_read_stack),
                     (k_thread_entry_t)sensor_read,
                     NULL, NULL, NULL, PRIORITY_4, 0, K_NO_WAIT);
+    INSTR_THREAD(&sensor_read_thread, "sensor_read");
     //printk("sensor_read thread created\n");
 
     k_thread_create(&anomaly_detect_thread, anomaly_detect_stack,
                     K_THREAD_STACK_SIZEOF(anomaly_detect_stack),
                     (k_thread_entry_t)anomaly_detect,
                     NULL, NULL, NULL, PRIORITY_5, 0, K_NO_WAIT);
+    INSTR_THREAD(&anomaly_detect_thread, "anomaly_detect");
     //printk("anomaly_detect thread created\n");
 
     k_thread_create(&anomaly_handle_thread, anomaly_handle_stack,
                     K_THREAD_STACK_SIZEOF(anomaly_handle_stack),
                     (k_thread_entry_t)anomaly_handle,
                     NULL, NULL, NULL, PRIORITY_6, 0, K_NO_WAIT);
+    INSTR_THREAD(&anomaly_handle_thread, "anomaly_handle");
     //printk("anomaly_handle thread created\n");
 
     k_thread_create(&system_log_thread, system_log_stack,
                     K_THREAD_STACK_SIZEOF(system_log_stack),
                     (k_thread_entry_t)system_log,
                     NULL, NULL, NULL, PRIORITY_7, 0, K_NO_WAIT);
+    INSTR_THREAD(&system_log_thread, "system_log");
     //printk("system_log thread created\n");
+
+#ifdef CONFIG_PM_STORE
+    k_thread_create(&store_write_thread, store_write_stack,
+                    K_THREAD_STACK_SIZEOF(store_write_stack),
+                    (k_thread_entry_t)store_write,
+                    NULL, NULL, NULL, PRIORITY_8, 0, K_NO_WAIT);
+    INSTR_THREAD(&store_write_thread, "store_write");
+
+    // Drains the store reader above the flash writer, so erases never stall it
+    k_thread_create(&store_fill_thread, store_fill_stack,
+                    K_THREAD_STACK_SIZEOF(store_fill_stack),
+                    (k_thread_entry_t)store_fill,
+                    NULL, NULL, NULL, PRIORITY_6, 0, K_NO_WAIT);
+    INSTR_THREAD(&store_fill_thread, "store_fill");
+#endif
 }
 
 /**
@@ -103,8 +150,8 @@ static void spawn_threads(void)
  * 
  * Performs one-time system initialization:
  *  - Run C++ interopability demo
- *  - Creates machine instances and registers sensors
- *  - Initializes the circular buffer
+ *  - Initializes the circular buffer and registers its readers
+ *  - Opens the flash history store (CONFIG_PM_STORE)
  *  - Spawns application threads
  *
  * After initialization, the function idles while
@@ -119,11 +166,22 @@ int main(void)
     // C++ interopability Demo                                     
     printk("Demo Message: %s\n", demo_get_message());
 
-    // Create machines and register their sensors
-    generate_machines_and_sensors();
+    // Machines and sensors need no set-up - the fleet topology is built at compile time (ROM)
 
-    // Initialize the circular buffer
-    circular_buffer_init(&circular_buffer);
+    // Initialize the circular buffer - oldest readings are overwritten when full
+    circular_buffer_init(&circular_buffer, CB_OVERWRITE_OLDEST);
+
+    // Every consumer reads the same entries through its own cursor
+    detect_reader = cb_reader_register(&circular_buffer, "detect", &buffer_data_sem);
+
+#ifdef CONFIG_PM_STORE
+    // Open the flash history and resume after the newest page - runs without it on failure
+    int rc = store_init();
+    if (rc != 0) {
+        printk("History store unavailable (%d)\n", rc);
+    }
+    store_reader = cb_reader_register(&circular_buffer, "store", &store_data_sem);
+#endif
 
     // Spawn threads after initialization is complete
     spawn_threads();
@@ -132,7 +190,13 @@ int main(void)
     
     // Keep main alive - threads drive all application logic
     while (1) {
+#ifdef CONFIG_PM_INSTRUMENTATION
+        // Periodic latency / CPU report through the system logger
+        k_msleep(CONFIG_PM_INSTRUMENTATION_DUMP_PERIOD_MS);
+        instr_dump();
+#else
         k_sleep(K_FOREVER);
+#endif
     }
 
     return 0;
@@ -6,66 +6,385 @@
 */
 
 #include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <zephyr/kernel.h>
 
 #include "threads.h"
+#include "wrapper.h"
+#include "sensor_bank.h"
+#include "detection.h"
+#include "statistics.h"
+#include "window.h"
+#include "spectrum.h"
+#include "rollup.h"
+#include "simulator.h"
 #include "shared_resources.h"
 #include "circular_buffer.h"
+#include "instrument.h"
+
+/**
+ * @brief One circular buffer span gathered into detection-friendly arrays.
+ *
+ * Static rather than on the 2 KB thread stack - only Thread 3 touches it.
+*/
+static struct {
+    pm_value_t value[BUFFER_SIZE];
+    pm_value_t min[BUFFER_SIZE];
+    pm_value_t max[BUFFER_SIZE];
+    uint16_t slot[BUFFER_SIZE];
+    uint32_t timestamp_ms[BUFFER_SIZE];
+    uint16_t seq[BUFFER_SIZE];
+    uint32_t mask[DETECT_MASK_WORDS(BUFFER_SIZE)];
+} batch;
+
+/** @brief Streaming statistics of every sensor, indexed by sensor bank slot */
+static sensor_stats_t stats[MAX_FLEET_SENSORS];
+
+/** @brief Sliding window of the last WINDOW_SIZE samples of every sensor, indexed by slot */
+static sensor_window_t windows[MAX_FLEET_SENSORS];
+
+/** @brief 1 s / 1 min / 1 h rollups of every sensor, indexed by slot */
+static sensor_rollup_t rollups[MAX_FLEET_SENSORS];
+static uint32_t last_rollup_expire_ms;
+
+#ifndef CONFIG_PM_FIXED_POINT
+/** @brief Spectral analysis parameters of the air compressor's vibration channel (float FFT - FPU builds only) */
+static const spectrum_config_t vibration_spectrum_cfg = {
+    .sample_rate_hz   = 1000.0f / (float)VIB_SAMPLE_PERIOD_MS,     /**< Vibration acquisition rate */
+    .running_speed_hz = SIM_DRIVE_SPEED_HZ,                         /**< Drive running speed */
+    .bearing_lo_hz    = 150.0f,
+    .bearing_hi_hz    = 400.0f
+};
+
+/** @brief Frame accumulators of the vibration channels, and the slot each one is bound to */
+static spectrum_frame_t vibration_frames[SPECTRUM_CHANNELS];
+static uint16_t vibration_frame_slot[SPECTRUM_CHANNELS];
+static uint8_t  vibration_frame_count;
+
+/** @brief Statistics of each channel's bearing-band energy, for a spectral z-score test */
+static sensor_stats_t bearing_stats[SPECTRUM_CHANNELS];
+#endif
+
+/** @brief Sequence number expected next, valid once the first reading has arrived */
+static uint16_t expected_seq;
+static bool     seq_started;
+
+/** @brief Readings dropped for a sensor ID outside the layout */
+static uint32_t invalid_readings;
+
+/** @brief Age of each reading when it reached detection */
+static latency_hist_t sample_age;
+static uint32_t last_latency_report_ms;
+
+/**
+ * @brief Check a reading's sequence number and report any readings lost before it.
+ *
+ * Wrap-aware: a sequence number up to half the range ahead counts as a
+ * gap, anything behind is taken as-is.
+*/
+static void check_sequence(uint16_t seq)
+{
+    if (seq_started) {
+        int16_t gap = (int16_t)(uint16_t)(seq - expected_seq);
+        if (gap > 0) {
+            log_msg_t gap_msg = {
+                .fmt = LOG_FMT_SEQ_GAP, .thread_id = 3,
+                .args = {{.u = expected_seq}, {.u = seq}, {.u = (uint32_t)gap}}
+            };
+            log_post(&gap_msg);
+        }
+    }
+    expected_seq = (uint16_t)(seq + 1U);
+    seq_started  = true;
+}
+
+/**
+ * @brief Post the summary of one latency histogram.
+*/
+static void log_latency(latency_report_t which, const latency_hist_t *h)
+{
+    latency_summary_t sum;
+    (void)latency_summary(h, &sum);
+
+    log_msg_t latency_msg = {
+        .fmt = LOG_FMT_LATENCY, .thread_id = 3, .slot = (uint16_t)which,
+        .args = {{.u = sum.count}, {.u = sum.p50_us}, {.u = sum.p99_us}, {.u = sum.max_us}}
+    };
+    log_post(&latency_msg);
+}
+
+/**
+ * @brief Post the lag and overrun count of every circular buffer reader.
+*/
+static void log_readers(void)
+{
+    uint32_t n = (uint32_t)atomic_get(&circular_buffer.readers);
+
+    for (uint32_t r = 0U; r < n; r++) {
+        const cb_reader_t *reader = &circular_buffer.reader[r];
+        log_msg_t reader_msg = {
+            .fmt = LOG_FMT_READER, .thread_id = 3, .slot = (uint16_t)r,
+            .args = {{.u = cb_lag(&circular_buffer, reader)}, {.u = cb_overruns(reader)}}
+        };
+        log_post(&reader_msg);
+    }
+}
+
+/**
+ * @brief Post the rollup windows just closed for one sensor (the short levels stay local).
+*/
+static void log_rollups(uint16_t slot, const rollup_record_t *rec, uint32_t n)
+{
+    for (uint32_t k = 0U; k < n; k++) {
+#if THREAD_ROLLUP_LOG_MIN_LEVEL > 0
+        if (rec[k].level < THREAD_ROLLUP_LOG_MIN_LEVEL) {
+            continue;
+        }
+#endif
+        log_msg_t rollup_msg = {
+            .fmt = LOG_FMT_ROLLUP, .thread_id = 3, .slot = slot,
+            .args = {{.u = rec[k].start_ms}, {.u = LOG_ROLLUP_PACK(rec[k].level, rec[k].count)},
+                     LOG_ARG_VALUE(rec[k].min), LOG_ARG_VALUE(rec[k].max),
+                     LOG_ARG_VALUE(rec[k].mean), LOG_ARG_VALUE(rec[k].last)}
+        };
+        log_post(&rollup_msg);
+    }
+}
+
+/**
+ * @brief Log one processed reading, flagged when out of range or a statistical outlier.
+*/
+static void log_reading(uint32_t i, uint32_t flags, pm_value_t z)
+{
+    log_msg_t sensor_msg = {
+        .fmt = LOG_FMT_READING, .thread_id = 3, .slot = batch.slot[i],
+        .args = {LOG_ARG_VALUE(batch.value[i]), LOG_ARG_VALUE(z), {.u = batch.timestamp_ms[i]}, {.u = flags}}
+    };
+    log_post(&sensor_msg);
+}
+
+/**
+ * @brief Log the windowed features of a vibration channel.
+*/
+static void log_vibration_window(uint16_t slot)
+{
+    const sensor_window_t *w = &windows[slot];
+
+    log_msg_t window_msg = {
+        .fmt = LOG_FMT_WINDOW, .thread_id = 3, .slot = slot,
+        .args = {{.u = window_length(w)}, LOG_ARG_VALUE(window_mean(w)), LOG_ARG_VALUE(window_min(w)),
+                 LOG_ARG_VALUE(window_max(w)), LOG_ARG_VALUE(window_rms(w))}
+    };
+    log_post(&window_msg);
+}
+
+#ifndef CONFIG_PM_FIXED_POINT
+/**
+ * @brief Feed a vibration sample into its channel's FFT frame and log the
+ *        band energies whenever a frame completes.
+*/
+static void push_vibration_sample(uint16_t slot, float value)
+{
+    uint8_t ch;
+
+    for (ch = 0U; ch < vibration_frame_count; ch++) {
+        if (vibration_frame_slot[ch] == slot) {
+            break;
+        }
+    }
+    if (ch == vibration_frame_count) {
+        if (vibration_frame_count >= SPECTRUM_CHANNELS) {
+            return;         // No accumulator left for this channel
+        }
+        if (sensor_layout.period_ms[slot] != VIB_SAMPLE_PERIOD_MS) {
+            return;         // Sampled at another rate - the bins would not match the configuration
+        }
+        vibration_frame_slot[vibration_frame_count++] = slot;
+    }
+
+    spectrum_features_t f;
+    if (!spectrum_frame_push(&vibration_frames[ch], value, &vibration_spectrum_cfg, &f)) {
+        return;
+    }
+
+    float z = stats_update(&bearing_stats[ch], f.band_bearing);
+    uint32_t flags = stats_is_outlier(&bearing_stats[ch], z, STATS_Z_THRESHOLD) ? LOG_FLAG_OUTLIER : 0U;
+
+    log_msg_t fft_msg = {
+        .fmt = LOG_FMT_SPECTRUM, .thread_id = 3, .slot = slot,
+        .args = {{.f = f.band_1x}, {.f = f.band_2x}, {.f = f.band_bearing},
+                 {.f = f.total_energy}, {.f = f.peak_hz}, {.u = flags}}
+    };
+    log_post(&fft_msg);
+}
+#endif
 
 /**
  * @brief Thread 3: Consume data from the circular buffer and perform anomaly detection
  * 
- * 
+ * Drains its reader of the circular buffer one contiguous span at a time
+ * (persistence reads the same entries through its own reader). Each span is
+ * gathered into structure-of-arrays form together with the matching
+ * operating ranges from the sensor bank, then checked in a single pass by
+ * the vectorized range-check kernel. Each reading is also folded into its
+ * sensor's streaming statistics (O(1), no history) for a z-score test and
+ * pushed into its sliding window (moving mean/min/max/RMS) and its
+ * compressed history (history.h) for trend queries, and aggregated
+ * into 1 s / 1 min / 1 h rollups; per reading only alerts are logged,
+ * routine data leaves as closed rollup windows. Vibration
+ * samples are also collected into FFT frames for band-energy analysis
+ * (float builds only - the FFT is not ported to CONFIG_PM_FIXED_POINT).
+ *
+ * Sequence gaps (readings lost before detection) are reported as they
+ * are found; sample age, sample-to-alert latency and the lag and overruns
+ * of every buffer reader are reported every THREAD_LATENCY_REPORT_PERIOD_MS.
 */
 void anomaly_detect(void)
 {
+    for (uint16_t slot = 0U; slot < MAX_FLEET_SENSORS; slot++) {
+        stats_init(&stats[slot], STATS_EWMA_ALPHA);
+        window_init(&windows[slot]);
+        rollup_init(&rollups[slot]);
+        history_init(&sensor_history[slot]);
+    }
+#ifndef CONFIG_PM_FIXED_POINT
+    for (uint8_t ch = 0U; ch < SPECTRUM_CHANNELS; ch++) {
+        spectrum_frame_init(&vibration_frames[ch]);
+        stats_init(&bearing_stats[ch], STATS_EWMA_ALPHA);
+    }
+#endif
+
     while (1) 
     {
-        log_msg_t msg = {.thread_id = 3, .message = "Reading circular buffer:"};
-        k_msgq_put(&log_queue, &msg, K_NO_WAIT);
+        // Block until sensor_read has put readings in the buffer
+        (void)k_sem_take(&buffer_data_sem, K_FOREVER);
 
-        struct sensor_reading reading;
+        const struct sensor_reading *span;
+        uint32_t count;
 
-        // Acquire mutex before draining the circular buffer
-        (void)k_mutex_lock(&buffer_mutex, K_FOREVER);
-        
-        // Drain the circular buffer and process each sensor reading
-        while(cb_read(&circular_buffer, &reading)) 
+        // Drain this thread's view of the buffer span by span, reading entries where they sit
+        while ((count = cb_read_peek(&circular_buffer, detect_reader, &span)) > 0U) 
         {
-            // Release mutex
-            (void)k_mutex_unlock(&buffer_mutex);
-            
-            // Log the reading to verify data is corretcly carried from Thread 2
-            char buf[LOG_MSG_SIZE];
-            snprintf(buf, sizeof(buf), "  %-25s | %-12s = %6.2f [%.2f-%.2f]",
-                reading.machine_name, reading.sensor_type,
-                (double)reading.value,
-                (double)reading.min_value,
-                (double)reading.max_value);
-
-            log_msg_t sensor_msg = {.thread_id = 3};
-            strncpy(sensor_msg.message, buf, LOG_MSG_SIZE - 1);
-            k_msgq_put(&log_queue, &sensor_msg, K_NO_WAIT);  
+            INSTR_BEGIN(t_detect);
+
+            // Gather values and their limits into contiguous arrays
+            uint32_t valid = 0U;
+            for (uint32_t i = 0U; i < count; i++)
+            {
+                uint16_t slot = span[i].sensor_id;
+                batch.seq[i]  = span[i].seq;
+                if (slot >= sensor_layout.count) {
+                    continue;       // Corrupt ID - dropped here, before it can index any per-slot state
+                }
+
+                batch.value[valid]        = span[i].value;
+                batch.timestamp_ms[valid] = span[i].timestamp_ms;
+                batch.slot[valid]         = slot;
+                batch.min[valid]          = sensor_layout.min[slot];
+                batch.max[valid]          = sensor_layout.max[slot];
+                valid++;
+            }
+
+            // Move this reader past the span - discard the batch if it was overwritten meanwhile
+            bool intact = cb_read_release(&circular_buffer, detect_reader, count);
+            k_sem_give(&buffer_space_sem);      // sensor_read may be waiting for room
+            if (!intact) {
+                log_msg_t lost_msg = {.fmt = LOG_FMT_OVERWRITTEN, .thread_id = 3};
+                log_post(&lost_msg);
+                continue;
+            }
+
+            // Sequence continuity covers dropped readings too - they arrived, they were not lost
+            for (uint32_t i = 0U; i < count; i++) {
+                check_sequence(batch.seq[i]);
+            }
+
+            if (valid < count) {
+                invalid_readings += count - valid;
+
+                log_msg_t invalid_msg = {
+                    .fmt = LOG_FMT_INVALID, .thread_id = 3,
+                    .args = {{.u = count - valid}, {.u = invalid_readings}}
+                };
+                log_post(&invalid_msg);
+            }
+            count = valid;
+
+            // One vectorized pass over the whole span
+            (void)detect_out_of_range(batch.value, batch.min, batch.max, count, batch.mask);
+
+            uint32_t now_ms = k_uptime_get_32();
+
+            for (uint32_t i = 0U; i < count; i++)
+            {
+                latency_record(&sample_age, (now_ms - batch.timestamp_ms[i]) * 1000U);
+
+                sensor_stats_t *st = &stats[batch.slot[i]];
+                pm_value_t z = stats_update(st, batch.value[i]);
+
+                window_push(&windows[batch.slot[i]], batch.value[i]);
+                history_append(&sensor_history[batch.slot[i]], batch.timestamp_ms[i], batch.value[i]);
+
+                rollup_record_t closed[ROLLUP_MAX_CLOSED];
+                uint32_t n_closed = rollup_push(&rollups[batch.slot[i]], batch.timestamp_ms[i],
+                                                batch.value[i], closed);
+                log_rollups(batch.slot[i], closed, n_closed);
+
+                uint32_t flags = 0U;
+                if ((batch.mask[i / 32U] >> (i % 32U)) & 1U) {
+                    flags |= LOG_FLAG_OUT_OF_RANGE;
+                }
+                if (stats_is_outlier(st, z, STATS_Z_THRESHOLD)) {
+                    flags |= LOG_FLAG_OUTLIER;
+                }
+                // Only alerts are logged per reading - routine data leaves as rollups
+                if (flags != 0U) {
+                    log_reading(i, flags, z);
+                }
+
+                // Wake anomaly_handle for every flagged reading
+                if (flags != 0U) {
+                    anomaly_event_t event = {
+                        .slot = batch.slot[i], .flags = (uint16_t)flags, .value = batch.value[i],
+                        .zscore = z, .timestamp_ms = batch.timestamp_ms[i]
+                    };
+                    (void)k_msgq_put(&anomaly_queue, &event, K_NO_WAIT);
+                }
+
+                if (sensor_layout.type[batch.slot[i]] == SENSOR_VIBRATION) {
+                    // Once per full window rather than per kHz sample
+                    if ((windows[batch.slot[i]].count % WINDOW_SIZE) == 0U) {
+                        log_vibration_window(batch.slot[i]);
+                    }
+#ifndef CONFIG_PM_FIXED_POINT
+                    push_vibration_sample(batch.slot[i], batch.value[i]);
+#endif
+                }
+            }
+            INSTR_END(INSTR_STAGE_DETECT, t_detect);
         }
 
-        k_msleep(THREAD_ANOMALY_DETECT_PERIOD_MS);
+        uint32_t now_ms = k_uptime_get_32();
+
+        // Close the windows of sensors that went quiet - behind the clock, so
+        // readings still in flight are not split off into a second record
+        if ((now_ms - last_rollup_expire_ms) >= THREAD_ROLLUP_EXPIRE_PERIOD_MS) {
+            last_rollup_expire_ms = now_ms;
+            for (uint16_t slot = 0U; slot < sensor_layout.count; slot++) {
+                rollup_record_t closed[ROLLUP_MAX_CLOSED];
+                log_rollups(slot, closed,
+                            rollup_expire(&rollups[slot], now_ms - THREAD_ROLLUP_EXPIRE_GRACE_MS, closed));
+            }
+        }
+
+        // Periodic freshness report: sample age at detection, sample to alert, reader backlogs
+        if ((now_ms - last_latency_report_ms) >= THREAD_LATENCY_REPORT_PERIOD_MS) {
+            last_latency_report_ms = now_ms;
+            log_latency(LATENCY_SAMPLE_AGE, &sample_age);
+            log_latency(LATENCY_SAMPLE_TO_ALERT, &alert_latency);
+            log_readers();
+        }
     }
 }
-
-// Perform simple anomaly detection by checking if value is out of valid range
-            // if (reading.value < reading.min_value || reading.value > reading.max_value) 
-            // {
-            //     char alert[LOG_MSG_SIZE];
-            //     snprintf(alert, sizeof(alert), "ALERT: %s - %s = %.2f out of range [%.2f-%.2f]",
-            //         reading.machine_name, 
-            //         reading.sensor_name, 
-            //         (double)reading.value, 
-            //         (double)reading.min_value, 
-            //         (double)reading.max_value);    
-
-            //     log_msg_t alert_msg = {.thread_id = 3};
-            //     strncpy(alert_msg.message, alert, LOG_MSG_SIZE - 1);
-            //     k_msgq_put(&log_queue, &alert_msg, K_NO_WAIT);
-            // }
\ No newline at end of file
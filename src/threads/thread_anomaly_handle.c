@@ -12,18 +12,33 @@
 
 #include "threads.h"
 #include "shared_resources.h"
+#include "instrument.h"
 
 /**
  * @brief Thread 4: Handle detected anomalies (event-driven -> triggered by anomaly_detector)
  * 
- * 
- * 
+ * Sleeps on the anomaly queue and only runs when anomaly_detect has
+ * posted an event - there is no periodic wakeup.
 */
 void anomaly_handle(void) 
 {
+    anomaly_event_t event;
+
     while (1) {
-        log_msg_t msg = {.thread_id = 4, .message = "In thread 4"};
-        k_msgq_put(&log_queue, &msg, K_NO_WAIT);
-        k_msleep(THREAD_ANOMALY_HANDLE_PERIOD_MS);
+        // Block until Thread 3 reports an anomaly
+        (void)k_msgq_get(&anomaly_queue, &event, K_FOREVER);
+        INSTR_BEGIN(t_handle);
+
+        log_msg_t msg = {
+            .fmt = LOG_FMT_ANOMALY_ALERT, .thread_id = 4, .slot = event.slot,
+            .args = {LOG_ARG_VALUE(event.value), LOG_ARG_VALUE(event.zscore),
+                     {.u = event.timestamp_ms}, {.u = event.flags}}
+        };
+        log_post(&msg);
+
+        // Acquisition to handled alert, the latency that matters for maintenance
+        latency_record(&alert_latency, (k_uptime_get_32() - event.timestamp_ms) * 1000U);
+
+        INSTR_END(INSTR_STAGE_HANDLE, t_handle);
     }
-}
\ No newline at end of file
+}
@@ -12,85 +12,115 @@
 
 #include "threads.h"
 #include "wrapper.h"
+#include "sensor_bank.h"
 #include "shared_resources.h"
 #include "circular_buffer.h"
+#include "instrument.h"
+
+/** @brief Sequence number of the next reading - one per sample, lost or not */
+static uint16_t next_seq;
+
+/**
+ * @brief Pause the sweep at the high-water mark until every reader has caught up.
+ *
+ * sensor_read runs above its readers, so on one core they cannot drain
+ * the buffer while it sweeps - waking them alone changes nothing until
+ * the sweep ends. Blocking here lets them run before the buffer starts
+ * overwriting. Each wait is bounded, so a stalled reader is lapped (and
+ * counts its overruns) rather than stopping acquisition.
+*/
+static void wait_for_readers(void)
+{
+    while (cb_max_lag(&circular_buffer) >= BUFFER_HIGH_WATER) {
+        cb_notify_readers(&circular_buffer, 1U);
+        if (k_sem_take(&buffer_space_sem, K_MSEC(THREAD_BUFFER_SPACE_TIMEOUT_MS)) != 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Push one sensor's current value into the circular buffer.
+*/
+static void collect_sensor(uint16_t slot)
+{
+    // Get the sensor value with its acquisition time - lock-free, retried if sensor_write was mid-update
+    uint16_t machine = sensor_layout.machine[slot];
+    pm_value_t value;
+    uint32_t acquired_ms;
+    uint32_t version;
+    do {
+        version     = sensor_bank_read_begin(machine);
+        value       = sensor_bank.value[slot];
+        acquired_ms = sensor_bank.timestamp_ms[slot];
+    } while (sensor_bank_read_retry(machine, version));
+
+    // Numbered even if the buffer refuses it, so the consumer sees the gap
+    uint16_t seq = next_seq++;
+
+    // Fill the next circular buffer slot in place (lock-free producer side)
+    INSTR_BEGIN(t_enqueue);
+    struct sensor_reading *reading = cb_write_reserve(&circular_buffer);
+    if (reading != NULL) {
+        reading->timestamp_ms = acquired_ms;
+        reading->value        = value;
+        reading->sensor_id    = slot;
+        reading->seq          = seq;
+        cb_write_commit(&circular_buffer);
+    }
+    INSTR_END(INSTR_STAGE_ENQUEUE, t_enqueue);
+
+    // Large batches: let the readers drain before the buffer starts overwriting
+    wait_for_readers();
+
+    // Log the operation - formatted later by the system logger (slow channels only)
+    if (sensor_layout.period_ms[slot] >= LOG_SAMPLE_MIN_PERIOD_MS) {
+        log_msg_t sensor_msg = {.fmt = LOG_FMT_SENSOR_VALUE, .thread_id = 2, .slot = slot,
+                                .args = {LOG_ARG_VALUE(value)}};
+        log_post(&sensor_msg);
+    }
+}
 
 /**
  * @brief Thread 2: Read sensor values and write into the circular buffer
  * 
- * Iterates through all machines and their sensors, retrieves the current
- * sensor value via the C++ wrapper, and pushes a @ref sensor_reading into
- * the circular buffer for consumption by the anomaly_detector (Thread 3).
+ * Collects only the sensors sensor_write has sampled since the last pass
+ * (the sensor bank's updated bitmap), retrieves each current value, and
+ * pushes a @ref sensor_reading into the circular buffer for consumption
+ * by every reader of the buffer (anomaly_detect, store_fill).
  * 
  * All output is routed through the logging message queue to be printed
  * by system_logger (Thread 5).
  * 
- * @note Runs every 5000ms
+ * @note Event-driven: woken by sensor_write, signals the buffer readers
 */
 void sensor_read(void)
 {    
     while (1) 
     {
-        log_msg_t msg = {.thread_id = 2, .message = "Getting sensor values:"};
-        k_msgq_put(&log_queue, &msg, K_NO_WAIT);
-
-        // Iterate through each machine and set all sensor values
-        for (u_int8_t i=0U; i<NUM_MACHINES; i++) 
-        {
-            // Get machine handle
-            MachineHandle machine = get_machine(i);
-            if (machine == NULL) {
-                continue;           // Skip invalid machine
-            }
-            
-            // Get machine type, name and sensor count
-            MachineType machineType = get_machine_type(machine);
-            uint8_t numSensors      = get_sensor_count(machine);
-            const char* machineName = get_machine_name(machine);
+        // Block until sensor_write has sampled something
+        (void)k_sem_take(&sensor_update_sem, K_FOREVER);
+        INSTR_BEGIN(t_collect);
 
-            // Set values for each sensor in this machine
-            for (uint8_t s = 0U; s < numSensors; s++) 
-            {
-                // Get sensor type and range
-                const char* sensorType = get_sensor_type(machine, s);
-                float minVal           = get_sensor_min_value(machine, sensorType);
-                float maxVal           = get_sensor_max_value(machine, sensorType);
+        // Samples sensor_write replaced before they were collected: skip their
+        // sequence numbers so detection reports them as a gap
+        next_seq += (uint16_t)atomic_clear(&sensor_bank.overwritten);
 
-                // Acquire mutex & Get the sensor value
-                (void)k_mutex_lock(&sensor_mutex, K_FOREVER);
-                float value = get_sensor_value(machine, sensorType);
-                (void)k_mutex_unlock(&sensor_mutex);
-
-                // Format the sensor readings for circular buffer 
-                struct sensor_reading reading = {
-                   // .machine_name = machineName,
-                   // .sensor_type = sensorType,
-                    .value = value,
-                    .min_value = minVal,
-                    .max_value = maxVal
-                };
-                strncpy(reading.machine_name, machineName, sizeof(reading.machine_name) - 1);
-                strncpy(reading.sensor_type, sensorType, sizeof(reading.sensor_type) - 1);
-
-                // Acquire mutex and write to circular buffer
-                (void)k_mutex_lock(&buffer_mutex, K_FOREVER);
-                cb_write(&circular_buffer, &reading);
-                (void)k_mutex_unlock(&buffer_mutex);
-
-                // Log the operation
-                static char buf[LOG_MSG_SIZE];
-                snprintf(buf, sizeof(buf), "  %-25s | %-12s = %6.2f [%.2f-%.2f]",
-                    machineName, sensorType,
-                    (double)value,
-                    (double)minVal,
-                    (double)maxVal);
+        // Claim the updated bits a word at a time and collect those sensors
+        for (uint32_t w = 0U; w < ATOMIC_BITMAP_SIZE(MAX_FLEET_SENSORS); w++) 
+        {
+            atomic_val_t bits = atomic_clear(&sensor_bank.updated[w]);
 
-                log_msg_t sensor_msg = {.thread_id = 2};
-                strncpy(sensor_msg.message, buf, LOG_MSG_SIZE - 1);
-                (void)k_msgq_put(&log_queue, &sensor_msg, K_NO_WAIT);
+            while (bits != 0) {
+                uint32_t bit = (uint32_t)__builtin_ctzl((unsigned long)bits);
+                bits &= bits - 1;
+                collect_sensor((uint16_t)(w * ATOMIC_BITS + bit));
             }
         }
-        // Sleep before next sensor update cycle
-        k_msleep(THREAD_SENSOR_READ_PERIOD_MS);
+
+        INSTR_END(INSTR_STAGE_COLLECT, t_collect);
+
+        // Wake every reader - the readings are in the buffer
+        cb_notify_readers(&circular_buffer, 1U);
     }
-}
\ No newline at end of file
+}
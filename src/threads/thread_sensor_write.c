@@ -6,79 +6,202 @@
 */
 
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <zephyr/kernel.h>
 
 #include "threads.h"
 #include "wrapper.h"
+#include "sensor_bank.h"
 #include "shared_resources.h"
 #include "circular_buffer.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "instrument.h"
+
+/** @brief Timer wheel holding the sampling deadline of every sensor */
+static sched_wheel_t sample_wheel;
+
+/** @brief Slots due on the current tick */
+static uint16_t due[MAX_FLEET_SENSORS];
+
+/** @brief New values of the due slots, at the same index */
+static pm_value_t due_value[MAX_FLEET_SENSORS];
+
+BUILD_ASSERT(MAX_FLEET_SENSORS <= SCHED_MAX_ENTRIES, "Timer wheel too small for the fleet");
+
+/** @brief Signal generator of every sensor, indexed by slot */
+static sim_channel_t channels[MAX_FLEET_SENSORS];
+
+#ifdef CONFIG_PM_SIM_FAULTS
+/**
+ * @brief Demo fault scenario, times relative to sensor_write start.
+ *
+ * One fault per sensor; entries naming a sensor not in the topology are ignored.
+*/
+static const struct {
+    uint16_t    sensor;         /**< Fleet sensor number */
+    sim_fault_t fault;
+} fault_script[] = {
+    // Compressor overheating: +40 degrees over two minutes, leaves its range halfway
+    { 0U, { .start_ms = 60000U,  .duration_ms = 120000U, .magnitude = Q16_CONST(40.0f),  .kind = SIM_FAULT_RAMP  } },
+    // Pressure surge on the second machine
+    { 4U, { .start_ms = 90000U,  .duration_ms = 500U,    .magnitude = Q16_CONST(200.0f), .kind = SIM_FAULT_SPIKE } },
+    // Vibration pickup frozen for 30 s
+    { 2U, { .start_ms = 120000U, .duration_ms = 30000U,  .magnitude = 0,                 .kind = SIM_FAULT_STUCK } },
+};
+#endif
+
+/**
+ * @brief Signal model of a sensor type.
+*/
+static sim_model_t model_of(uint8_t type)
+{
+    switch (type) {
+    case SENSOR_PRESSURE:
+        return SIM_MODEL_PRESSURE;
+    case SENSOR_VIBRATION:
+        return SIM_MODEL_VIBRATION;
+    case SENSOR_TEMPERATURE:
+    default:
+        return SIM_MODEL_THERMAL;
+    }
+}
+
+/**
+ * @brief Set up the generator of every sensor, and schedule the demo faults.
+*/
+static void init_channels(uint32_t now_ms)
+{
+    for (uint16_t slot = 0U; slot < sensor_layout.count; slot++) {
+        sim_init(&channels[slot], model_of(sensor_layout.type[slot]), sensor_layout.min[slot],
+                 sensor_layout.max[slot], (uint32_t)sensor_layout.number[slot] + 1U);
+    }
+
+#ifdef CONFIG_PM_SIM_FAULTS
+    for (uint32_t i = 0U; i < ARRAY_SIZE(fault_script); i++) {
+        uint16_t slot = find_sensor_slot(fault_script[i].sensor);
+        if (slot == SENSOR_SLOT_NONE) {
+            continue;
+        }
+        sim_fault_t fault = fault_script[i].fault;
+        fault.start_ms += now_ms;
+        sim_inject(&channels[slot], &fault);
+    }
+#else
+    (void)now_ms;
+#endif
+}
+
+/**
+ * @brief Sort slots in ascending order (insertion sort - a tick has few due slots).
+*/
+static void sort_slots(uint16_t *slots, uint32_t count)
+{
+    for (uint32_t i = 1U; i < count; i++) {
+        uint16_t slot = slots[i];
+        uint32_t j = i;
+        while (j > 0U && slots[j - 1U] > slot) {
+            slots[j] = slots[j - 1U];
+            j--;
+        }
+        slots[j] = slot;
+    }
+}
+
+/**
+ * @brief Produce new samples for the sensors due on one tick and mark them for collection.
+ *
+ * The sensors of each machine are published in one sequence-lock write,
+ * so a reader sees all of a machine's values of this tick or none.
+ *
+ * @param count Number of slots in due[].
+ * @param now   Scheduled sampling time (ms) - the tick being processed,
+ *              so samples taken while catching up keep their spacing.
+*/
+static void sample_due(uint32_t count, uint32_t now)
+{
+    // A machine owns contiguous slots - in slot order its due sensors are adjacent
+    sort_slots(due, count);
+
+    // Next value of each sensor's physical model (plus any scripted fault)
+    for (uint32_t i = 0U; i < count; i++) {
+        due_value[i] = sim_sample(&channels[due[i]], now);
+    }
+
+    // Publish machine by machine and mark the slots for sensor_read
+    uint32_t first = 0U;
+    while (first < count) {
+        uint16_t machine = sensor_layout.machine[due[first]];
+        uint32_t last = first + 1U;
+        while (last < count && sensor_layout.machine[due[last]] == machine) {
+            last++;
+        }
+        sensor_bank_store_n(machine, &due[first], &due_value[first], last - first, now);
+        first = last;
+    }
+
+    // Log the operation - formatted later by the system logger (slow channels only)
+    for (uint32_t i = 0U; i < count; i++) {
+        if (sensor_layout.period_ms[due[i]] >= LOG_SAMPLE_MIN_PERIOD_MS) {
+            log_msg_t sensor_msg = {.fmt = LOG_FMT_SENSOR_VALUE, .thread_id = 1, .slot = due[i],
+                                    .args = {LOG_ARG_VALUE(due_value[i])}};
+            log_post(&sensor_msg);
+        }
+    }
+}
 
 /**
  * @brief Thread 1: Write sensor values into sensor objects
  * 
- * Iterates through all machines and their sensors, generates a random value
- * within each sensor's configured range, and writes it via the C++ wrapper.
+ * Every sensor is sampled at its own rate. A timer wheel holds each
+ * sensor's next deadline; on every tick only the sensors that are due
+ * are touched, so slow channels are not oversampled, fast channels are
+ * not starved, and a tick costs nothing for sensors that are not due.
+ * Values come from each sensor's simulated physical model (simulator.h),
+ * with the demo fault scenario on top when CONFIG_PM_SIM_FAULTS is set.
  * 
  * All output is routed through the logging message queue to be printed
  * by system_logger (Thread 5).
  * 
- * @note Runs every 5000ms
+ * @note Sleeps until the next deadline and signals sensor_read after each tick with work
 */
 void sensor_write(void) 
 {
-    static char buf[LOG_MSG_SIZE];
+    init_channels(k_uptime_get_32());
+
+    uint32_t now = k_uptime_get_32() / SCHED_TICK_MS;
+
+    // Spread the first deadlines by machine, so equal-period sensors of different
+    // machines do not all fall on one tick and overrun the buffer in a single sweep,
+    // while the sensors of one machine stay on common ticks
+    sched_init(&sample_wheel, now);
+    for (uint16_t slot = 0U; slot < sensor_layout.count; slot++) {
+        uint32_t period = MAX(sensor_layout.period_ms[slot] / SCHED_TICK_MS, 1U);
+        (void)sched_add(&sample_wheel, slot, period, now + 1U + (sensor_layout.machine[slot] % period));
+    }
 
     while (1) 
     {
-        log_msg_t msg = {.thread_id = 1, .message = "Setting sensor values:"};
-        k_msgq_put(&log_queue, &msg, K_NO_WAIT);
+        bool sampled = false;
+        INSTR_BEGIN(t_write);
 
-        // Iterate through each machine and set all sensor values
-        for (uint8_t i=0U; i<NUM_MACHINES; i++) 
+        // Catch the wheel up with real time, sampling whatever falls due
+        now = k_uptime_get_32() / SCHED_TICK_MS;
+        while ((int32_t)(now - sample_wheel.now) > 0) 
         {
-            // Get machine handle
-            MachineHandle machine = get_machine(i);
-            if (machine == NULL) {
-                continue;           // Skip invalid machine
-            }
-            
-            // Get machine type, name and sensor count
-            MachineType machineType = get_machine_type(machine);
-            uint8_t numSensors      = get_sensor_count(machine);
-            const char* machineName = get_machine_name(machine);
-
-            // Set values for each sensor in this machine
-            for (uint8_t s = 0U; s < numSensors; s++) 
-            {
-                // Get sensor type and range
-                const char* sensorType = get_sensor_type(machine, s);
-                float minVal           = get_sensor_min_value(machine, sensorType);
-                float maxVal           = get_sensor_max_value(machine, sensorType);
-
-                // Generate random value within range
-                float range = maxVal - minVal;
-                float value = minVal + ((float)rand() / (float)RAND_MAX) * range;
-
-                // Acquire mutex & Set the sensor value
-                (void)k_mutex_lock(&sensor_mutex, K_FOREVER);
-                set_sensor_value(machine, sensorType, value);
-                (void)k_mutex_unlock(&sensor_mutex);
-
-                // Log the operation
-                snprintf(buf, sizeof(buf), "  %-25s | %-12s = %6.2f [%.2f-%.2f]",
-                    machineName, sensorType,
-                    (double)value,
-                    (double)minVal,
-                    (double)maxVal);
-
-                log_msg_t sensor_msg = {.thread_id = 1};
-                strncpy(sensor_msg.message, buf, LOG_MSG_SIZE - 1);
-                (void)k_msgq_put(&log_queue, &sensor_msg, K_NO_WAIT);
-            }
+            uint32_t count = sched_tick(&sample_wheel, due, MAX_FLEET_SENSORS);
+            sample_due(count, sample_wheel.now * SCHED_TICK_MS);
+            sampled |= (count > 0U);
         }
-        // Sleep before next sensor update cycle
-        k_msleep(THREAD_SENSOR_WRITE_PERIOD_MS);
+
+        // Wake sensor_read - fresh values are ready
+        if (sampled) {
+            INSTR_END(INSTR_STAGE_WRITE, t_write);
+            k_sem_give(&sensor_update_sem);
+        }
+
+        // Sleep until the next sensor falls due
+        uint32_t next = sched_next_deadline(&sample_wheel);
+        k_sleep(K_MSEC((next - now) * SCHED_TICK_MS));
     }
-}
\ No newline at end of file
+}
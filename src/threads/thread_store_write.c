@@ -0,0 +1,62 @@
+/**
+ * @file thread_store_write.c
+ * @brief Page filler and flash writer of the persistent reading history.
+*/
+
+#include <zephyr/kernel.h>
+
+#include "threads.h"
+#include "shared_resources.h"
+#include "circular_buffer.h"
+#include "store.h"
+
+/**
+ * @brief Thread 6: Program full history pages to flash (event-driven -> triggered by store_fill)
+ *
+ * Runs at the lowest priority, so page programming and segment erases
+ * never delay acquisition or detection. While it waits for flash,
+ * store_fill keeps packing readings into the remaining page buffers.
+*/
+void store_write(void)
+{
+    while (1) {
+        // Block until store_fill has handed over a full page
+        (void)k_sem_take(&store_page_sem, K_FOREVER);
+
+        // Program the full pages, including any completed meanwhile
+        while (store_service() > 0U) {
+        }
+    }
+}
+
+/**
+ * @brief Thread 7: Pack every reading into history pages (event-driven -> triggered by sensor_read)
+ *
+ * Reads the circular buffer through its own reader, independently of
+ * anomaly_detect, and only copies into RAM page buffers - it never waits
+ * for flash, so a segment erase in store_write does not let the buffer
+ * lap this reader. Readings arriving with every page buffer pending are
+ * dropped and counted by the store (store_stats_t.dropped).
+*/
+void store_fill(void)
+{
+    struct sensor_reading batch[THREAD_STORE_DRAIN_BATCH];
+
+    while (1) {
+        // Block until sensor_read has published readings
+        (void)k_sem_take(&store_data_sem, K_FOREVER);
+
+        uint32_t n;
+        while ((n = cb_read_n(&circular_buffer, store_reader, batch, ARRAY_SIZE(batch))) > 0U) {
+            k_sem_give(&buffer_space_sem);      // sensor_read may be waiting for room
+            for (uint32_t i = 0U; i < n; i++) {
+                (void)store_append(&batch[i]);
+            }
+        }
+
+        // Wake the flash writer once a page is complete
+        if (store_pending() > 0U) {
+            k_sem_give(&store_page_sem);
+        }
+    }
+}
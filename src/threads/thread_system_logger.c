@@ -11,22 +11,217 @@
 #include <zephyr/kernel.h>
 
 #include "threads.h"
+#include "wrapper.h"
+#include "sensor_bank.h"
 #include "shared_resources.h"
+#include "instrument.h"
+#include "rollup.h"
+#include "circular_buffer.h"
+
+/**
+ * @brief Machine name of a sensor slot, resolved through the registry.
+*/
+static const char* slot_machine(uint16_t slot)
+{
+    if (slot >= sensor_layout.count) {
+        return "unknown";
+    }
+    return get_machine_name(get_machine(sensor_layout.machine[slot]));
+}
+
+/**
+ * @brief Sensor type name of a sensor slot.
+*/
+static const char* slot_type(uint16_t slot)
+{
+    if (slot >= sensor_layout.count) {
+        return "unknown";
+    }
+    return sensor_type_name((SensorType)sensor_layout.type[slot]);
+}
+
+/**
+ * @brief Lower bound of a sensor slot's operating range (0 if the slot is invalid).
+*/
+static double slot_min(uint16_t slot)
+{
+    return (slot < sensor_layout.count) ? (double)pm_value_to_float(sensor_layout.min[slot]) : 0.0;
+}
+
+/**
+ * @brief Upper bound of a sensor slot's operating range (0 if the slot is invalid).
+*/
+static double slot_max(uint16_t slot)
+{
+    return (slot < sensor_layout.count) ? (double)pm_value_to_float(sensor_layout.max[slot]) : 0.0;
+}
+
+/**
+ * @brief Value of a LOG_ARG_VALUE() argument - the only place a fixed-point value becomes a float.
+*/
+static double arg_value(log_arg_t a)
+{
+#ifdef CONFIG_PM_FIXED_POINT
+    return (double)pm_value_to_float(a.i);
+#else
+    return (double)a.f;
+#endif
+}
+
+/**
+ * @brief Render a binary log record into text.
+ *
+ * All float formatting and ID-to-name resolution of the application
+ * happens here, at the logger's priority, instead of in the producers.
+ *
+ * @param msg Record taken from the logging queue.
+ * @param buf Output buffer.
+ * @param len Size of the output buffer.
+*/
+static void log_format(const log_msg_t *msg, char *buf, size_t len)
+{
+    const log_arg_t *a = msg->args;
+    uint16_t slot = msg->slot;
+
+    switch (msg->fmt) {
+    case LOG_FMT_SENSOR_VALUE:
+        snprintf(buf, len, "  %-25s | %-12s = %6.2f [%.2f-%.2f]",
+            slot_machine(slot), slot_type(slot),
+            arg_value(a[0]),
+            slot_min(slot),
+            slot_max(slot));
+        break;
+
+    case LOG_FMT_OVERWRITTEN:
+        snprintf(buf, len, "  readings overwritten while processing");
+        break;
+
+    case LOG_FMT_INVALID:
+        snprintf(buf, len, "  %u readings with an unknown sensor ID dropped (%u total)",
+            (unsigned int)a[0].u,
+            (unsigned int)a[1].u);
+        break;
+
+    case LOG_FMT_READING:
+        snprintf(buf, len, "%s %-25s | %-12s = %6.2f [%.2f-%.2f] z=%+.1f @%u ms",
+            (a[3].u & LOG_FLAG_OUT_OF_RANGE) ? "ALERT:" :
+                ((a[3].u & LOG_FLAG_OUTLIER) ? "Z-OUT:" : "      "),
+            slot_machine(slot), slot_type(slot),
+            arg_value(a[0]),
+            slot_min(slot),
+            slot_max(slot),
+            arg_value(a[1]),
+            (unsigned int)a[2].u);
+        break;
+
+    case LOG_FMT_WINDOW:
+        snprintf(buf, len, "       %-25s | window[%u] avg=%.2f min=%.2f max=%.2f rms=%.2f",
+            slot_machine(slot),
+            (unsigned int)a[0].u,
+            arg_value(a[1]),
+            arg_value(a[2]),
+            arg_value(a[3]),
+            arg_value(a[4]));
+        break;
+
+    case LOG_FMT_SPECTRUM:
+        snprintf(buf, len, "%s %-25s | fft 1x=%.3g 2x=%.3g brg=%.3g tot=%.3g pk=%.1fHz",
+            (a[5].u & LOG_FLAG_OUTLIER) ? "SPECT:" : "      ",
+            slot_machine(slot),
+            (double)a[0].f,
+            (double)a[1].f,
+            (double)a[2].f,
+            (double)a[3].f,
+            (double)a[4].f);
+        break;
+
+    case LOG_FMT_ANOMALY_ALERT:
+        snprintf(buf, len, "*** ANOMALY *** %s %s = %.2f [%.2f-%.2f] z=%+.1f%s @%u ms",
+            slot_machine(slot), slot_type(slot),
+            arg_value(a[0]),
+            slot_min(slot),
+            slot_max(slot),
+            arg_value(a[1]),
+            (a[3].u & LOG_FLAG_OUT_OF_RANGE) ? " out of range" : " statistical outlier",
+            (unsigned int)a[2].u);
+        break;
+
+    case LOG_FMT_ROLLUP:
+        snprintf(buf, len, "[%-4s] %-25s | %-12s n=%u min=%.2f max=%.2f avg=%.2f last=%.2f @%u ms",
+            rollup_level_name((rollup_level_t)LOG_ROLLUP_LEVEL(a[1].u)),
+            slot_machine(slot), slot_type(slot),
+            (unsigned int)LOG_ROLLUP_COUNT(a[1].u),
+            arg_value(a[2]),
+            arg_value(a[3]),
+            arg_value(a[4]),
+            arg_value(a[5]),
+            (unsigned int)a[0].u);
+        break;
+
+    case LOG_FMT_SEQ_GAP:
+        snprintf(buf, len, "  sequence gap: expected %u, got %u (%u readings lost)",
+            (unsigned int)a[0].u,
+            (unsigned int)a[1].u,
+            (unsigned int)a[2].u);
+        break;
+
+    case LOG_FMT_LATENCY:
+        snprintf(buf, len, "[latency] %-15s n=%u p50=%uus p99=%uus max=%uus",
+            (slot == LATENCY_SAMPLE_AGE) ? "sample age" : "sample->alert",
+            (unsigned int)a[0].u,
+            (unsigned int)a[1].u,
+            (unsigned int)a[2].u,
+            (unsigned int)a[3].u);
+        break;
+
+    case LOG_FMT_READER:
+        snprintf(buf, len, "[reader] %-15s lag=%u overruns=%u",
+            (slot < CB_MAX_READERS && circular_buffer.reader[slot].name != NULL) ?
+                circular_buffer.reader[slot].name : "?",
+            (unsigned int)a[0].u,
+            (unsigned int)a[1].u);
+        break;
+
+#ifdef CONFIG_PM_INSTRUMENTATION
+    case LOG_FMT_STAGE_STATS:
+        snprintf(buf, len, "[stats] %-10s n=%u p50=%uus p99=%uus max=%uus",
+            instr_stage_name((instr_stage_t)slot),
+            (unsigned int)a[0].u,
+            (unsigned int)a[1].u,
+            (unsigned int)a[2].u,
+            (unsigned int)a[3].u);
+        break;
+
+    case LOG_FMT_THREAD_CPU:
+        snprintf(buf, len, "[stats] cpu %-14s %u.%u%%",
+            instr_thread_name(slot),
+            (unsigned int)(a[0].u / 10U),
+            (unsigned int)(a[0].u % 10U));
+        break;
+#endif
+
+    default:
+        snprintf(buf, len, "unknown log record %u", (unsigned int)msg->fmt);
+        break;
+    }
+}
 
 /**
  * @brief Thread 5: Consume log messages from the logging queue and print to terminal
  * 
- * 
- * 
+ * Producers enqueue compact binary records; this thread turns them into
+ * text, so formatting cost stays off the acquisition and detection threads.
 */
 void system_log(void) 
 {
     log_msg_t msg;
+    static char buf[LOG_MSG_SIZE];
 
     while (1) 
     {
         // Block wait for item on the message queue
         k_msgq_get(&log_queue, &msg, K_FOREVER);
-        printk("Thread %d: %s\n", msg.thread_id, msg.message);
+        log_format(&msg, buf, sizeof(buf));
+        printk("Thread %d: %s\n", msg.thread_id, buf);
     }
-}
\ No newline at end of file
+}